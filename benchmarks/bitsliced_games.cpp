@@ -0,0 +1,143 @@
+/* Bitsliced Games Benchmark
+*
+* Games per second of one game at a time (GameKernel.h play and
+* playCycle) against bitsliced games in lockstep, 64 lanes in 64-bit
+* words and the widest lanes compiled in (256 with AVX2, configure with
+* -DGP_NATIVE=ON). All play the same random strategy pairs and their
+* scores have to match.
+*
+* Then whole GAP generations in KERNEL, CYCLE and BITSLICED mode, with
+* population stats that have to be bit-identical.
+*
+* build: cmake --build build --target bitsliced_games
+* usage: bitsliced_games [games] [gameRounds] [popSize] [generations]
+*/
+
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Outcome {
+	double seconds{ 0.0 };
+	std::vector<gap::GameScore> scores;
+};
+
+template<typename Play>
+auto measure(std::size_t games, Play && play) -> Outcome {
+	Outcome outcome;
+	outcome.scores.resize(games);
+	auto start{ std::chrono::steady_clock::now() };
+	play(outcome.scores);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	outcome.seconds = elapsed.count();
+	return outcome;
+}
+
+auto sameScores(const Outcome & a, const Outcome & b) -> bool {
+	for (std::size_t g = 0; g < a.scores.size(); g++) {
+		if (a.scores[g].first != b.scores[g].first || a.scores[g].second != b.scores[g].second) return false;
+	}
+	return true;
+}
+
+auto sameBits(double a, double b) -> bool {
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	std::size_t games{ 200000 };
+	std::size_t gameRounds{ 150 };
+	gap::GAPConfig config;
+	config.popSize = 2000;
+	int generations{ 2 };
+
+	if (argc > 1) games = std::stoul(argv[1]);
+	if (argc > 2) gameRounds = std::stoul(argv[2]);
+	if (argc > 3) config.popSize = std::stoul(argv[3]);
+	if (argc > 4) generations = std::stoi(argv[4]);
+	config.gameRounds = gameRounds;
+
+	// 1024 random strategies, random pairs of them
+	constexpr std::size_t nStrategies{ 1024 };
+	std::vector<gap::PackedStrategy> strategies(nStrategies);
+	std::vector<gap::GamePair> pairs(games);
+	std::mt19937_64 rng{ 7u };
+	for (gap::PackedStrategy & s : strategies) {
+		s.answers = rng();
+		s.view = static_cast<std::uint32_t>(rng() & gap::kernel::viewMask);
+	}
+	for (gap::GamePair & p : pairs) {
+		p.first = static_cast<std::uint32_t>(rng() % nStrategies);
+		p.second = static_cast<std::uint32_t>(rng() % nStrategies);
+	}
+
+	Outcome kernel{ measure(games, [&](std::vector<gap::GameScore> & scores) {
+		for (std::size_t g = 0; g < games; g++)
+			scores[g] = gap::kernel::play(strategies[pairs[g].first], strategies[pairs[g].second], gameRounds);
+	}) };
+	Outcome cycle{ measure(games, [&](std::vector<gap::GameScore> & scores) {
+		for (std::size_t g = 0; g < games; g++)
+			scores[g] = gap::kernel::playCycle(strategies[pairs[g].first], strategies[pairs[g].second], gameRounds);
+	}) };
+	Outcome narrow{ measure(games, [&](std::vector<gap::GameScore> & scores) {
+		std::span<const gap::GamePair> all{ pairs };
+		for (std::size_t begin = 0; begin < games; begin += 64) {
+			std::size_t n{ std::min<std::size_t>(64, games - begin) };
+			gap::bitsliced::playBlock<gap::bitsliced::Lanes64>(strategies, all.subspan(begin, n), gameRounds,
+				std::span<gap::GameScore>{ scores }.subspan(begin, n));
+		}
+	}) };
+	Outcome wide{ measure(games, [&](std::vector<gap::GameScore> & scores) {
+		gap::bitsliced::play(strategies, pairs, gameRounds, scores);
+	}) };
+
+	std::cout << "games: " << games << "  rounds per game: " << gameRounds << '\n';
+	std::cout << std::left << std::setw(28) << "" << std::right << std::setw(16) << "games/s" << std::setw(12) << "speedup" << '\n';
+	auto row = [&](const std::string & name, const Outcome & o) {
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(16) << games / o.seconds << std::setprecision(2)
+			<< std::setw(11) << kernel.seconds / o.seconds << 'x' << '\n' << std::defaultfloat;
+	};
+	row("kernel", kernel);
+	row("cycle kernel", cycle);
+	row("bitsliced, 64-bit words", narrow);
+	row("bitsliced play, " + std::to_string(gap::bitsliced::lanes) + " lanes", wide);
+
+	bool same{ sameScores(kernel, cycle) && sameScores(kernel, narrow) && sameScores(kernel, wide) };
+	std::cout << "scores match: " << (same ? "yes" : "NO") << "\n\n";
+
+	std::cout << "GAP popSize: " << config.popSize << "  generations: " << generations << '\n';
+	gap::GAPStats first{};
+	double firstSeconds{ 0.0 };
+	for (gap::GameMode mode : { gap::GameMode::KERNEL, gap::GameMode::CYCLE, gap::GameMode::BITSLICED }) {
+		config.game = mode;
+		gap::GAP<> game{ config };
+		auto start{ std::chrono::steady_clock::now() };
+		game.step(generations);
+		std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+		gap::GAPStats stats{ game.stats() };
+		if (mode == gap::GameMode::KERNEL) {
+			first = stats;
+			firstSeconds = elapsed.count();
+		}
+		same = same && sameBits(stats.sum, first.sum) && sameBits(stats.max, first.max) && sameBits(stats.min, first.min);
+
+		const char * name{ mode == gap::GameMode::KERNEL ? "KERNEL" : mode == gap::GameMode::CYCLE ? "CYCLE" : "BITSLICED" };
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(15) << elapsed.count() << 's' << std::setprecision(2)
+			<< std::setw(11) << firstSeconds / elapsed.count() << 'x' << '\n' << std::defaultfloat;
+	}
+	std::cout << "identical across modes: " << (same ? "yes" : "NO") << '\n';
+	return same ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+/* Checkpoint Resume
+*
+* Runs SGA, GeneticAlgorithm and GAP for N generations straight, then
+* again saving a checkpoint at generation k, reloading it into a new
+* engine and finishing the run. Stats of both runs have to be
+* bit-identical.
+*
+* Every snapshot is saved to two files right after each other, so the
+* writer must keep the first one although the second comes before it is
+* on disk; runs resumed from either file are checked.
+*
+* build: cmake --build build --target checkpoint_resume
+* usage: checkpoint_resume [generations] [k] [directory]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+#include "../genetic_sine_maximum/GA.h"
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace {
+
+template<typename T>
+auto sameBits(const T & a, const T & b) -> bool {
+	return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+auto same(const SGAStats & a, const SGAStats & b) -> bool {
+	return sameBits(a.sumFitness, b.sumFitness) && sameBits(a.avgFitness, b.avgFitness)
+		&& sameBits(a.maxFitness, b.maxFitness) && sameBits(a.minFitness, b.minFitness)
+		&& sameBits(a.generations, b.generations) && sameBits(a.mutations, b.mutations)
+		&& sameBits(a.crossings, b.crossings) && sameBits(a.evaluations, b.evaluations)
+		&& sameBits(a.rawMaxFitness, b.rawMaxFitness);
+}
+
+auto same(const GAStats & a, const GAStats & b) -> bool {
+	return sameBits(a.generation, b.generation) && sameBits(a.sum, b.sum) && sameBits(a.avg, b.avg)
+		&& sameBits(a.max, b.max) && sameBits(a.min, b.min) && a.best.chrom == b.best.chrom
+		&& sameBits(a.best.fitness, b.best.fitness) && sameBits(a.evaluations, b.evaluations);
+}
+
+auto same(const gap::GAPStats & a, const gap::GAPStats & b) -> bool {
+	return sameBits(a.generation, b.generation) && sameBits(a.sum, b.sum) && sameBits(a.avg, b.avg)
+		&& sameBits(a.max, b.max) && sameBits(a.min, b.min) && sameBits(a.games, b.games)
+		&& sameBits(a.distinct, b.distinct);
+}
+
+auto report(const std::string & name, bool same) -> bool {
+	std::cout << name << ": " << (same ? "match" : "MISMATCH") << '\n';
+	return same;
+}
+
+// straight run against runs resumed from both snapshot files, make builds engine of config
+template<typename Make>
+auto check(const std::string & name, const std::string & path, int generations, int k, Make && make) -> bool {
+	auto straight{ make() };
+	straight->step(generations);
+	auto expected{ straight->stats() };
+
+	{
+		auto saved{ make() };
+		saved->step(k);
+		saved->saveCheckpoint(path + ".a");
+		saved->saveCheckpoint(path + ".b");
+	}	// engine waits for its writer here
+
+	bool ok{ true };
+	for (const char * suffix : { ".a", ".b" }) {
+		auto resumed{ make() };
+		bool loaded{ resumed->loadCheckpoint(path + suffix) };
+		if (loaded) resumed->step(generations - k);
+		ok = report(name + ", resumed from " + suffix + " file", loaded && same(resumed->stats(), expected)) && ok;
+		std::filesystem::remove(path + suffix);
+	}
+	return ok;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	int generations{ 60 };
+	int k{ 23 };
+	if (argc > 1) generations = std::stoi(argv[1]);
+	if (argc > 2) k = std::stoi(argv[2]);
+	std::filesystem::path directory{ argc > 3 ? argv[3] : std::filesystem::temp_directory_path().string() };
+	std::string path{ (directory / "checkpoint_resume").string() };
+
+	SGAConfig sgaConfig;
+	sgaConfig.seed = 7;		// 0 draws a random seed
+	sgaConfig.maxGenerations = generations;
+	sgaConfig.chromosomeLen = 70;
+	sgaConfig.selectMethod = SelectMethod::SUS;
+
+	GAConfig gaConfig;
+	gaConfig.popSize = 40;
+	gaConfig.variables = { GAVariable{}, GAVariable{ -2.0, 1.0, 50 } };
+
+	gap::GAPConfig gapConfig;
+	gapConfig.popSize = 30;
+	gapConfig.gameCache = 1000;
+
+	bool ok{ true };
+	ok = check("SGA", path, generations, k, [&] {
+		return std::make_unique<SGA<>>(sgaConfig, [](double x) { return std::sin(x) + 2.0; });
+	}) && ok;
+	ok = check("GeneticAlgorithm", path, generations, k, [&] {
+		return std::make_unique<GeneticAlgorithm<>>(gaConfig);
+	}) && ok;
+	ok = check("GAP", path, generations, k, [&] {
+		return std::make_unique<gap::GAP<>>(gapConfig);
+	}) && ok;
+
+	std::cout << "resumed runs identical to straight ones: " << (ok ? "yes" : "NO") << '\n';
+	return ok ? 0 : 1;
+}
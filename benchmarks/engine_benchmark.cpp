@@ -0,0 +1,301 @@
+/* Engine Benchmark
+*
+* Runs every evolution engine over its main parameter and reports
+* generations/s, fitness evaluations/s, heap allocations per generation
+* and peak resident memory of each case:
+*
+*	SGA					- SelectMethod x ScalingType
+*	GeneticAlgorithm	- population sizes
+*	GAP					- gameRounds (one evaluation is one game)
+*	Pathfinder			- obstacle counts
+*
+* Results go to stdout as table and to JSON file, for comparing versions.
+* Allocations are counted by replaced global operator new, peak memory is
+* VmHWM of the process, reset before every case where kernel allows it.
+*
+* build: cmake -S . -B build && cmake --build build --target engine_benchmark
+* usage: engine_benchmark [output.json] [generationScale]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+#include "../genetic_sine_maximum/GA.h"
+#include "../genetic_prisoners_dilemma/GAP.h"
+#include "../evolutionary_pathfinding/pathfinder.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{ 0 };
+
+}
+
+auto operator new(std::size_t n) -> void* {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void * p = std::malloc(n ? n : 1)) return p;
+	throw std::bad_alloc{};
+}
+
+auto operator new(std::size_t n, std::align_val_t align) -> void* {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	std::size_t alignment{ static_cast<std::size_t>(align) };
+	if (void * p = std::aligned_alloc(alignment, (n + alignment - 1) / alignment * alignment)) return p;
+	throw std::bad_alloc{};
+}
+
+auto operator new[](std::size_t n) -> void* { return operator new(n); }
+auto operator new[](std::size_t n, std::align_val_t align) -> void* { return operator new(n, align); }
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void * p) noexcept { std::free(p); }
+void operator delete[](void * p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+// discards engine output without allocating
+class NullBuffer : public std::streambuf {
+protected:
+	auto overflow(int c) -> int override { return c; }
+	auto xsputn(const char *, std::streamsize n) -> std::streamsize override { return n; }
+};
+
+class Silence {
+	NullBuffer sink;
+	std::streambuf * out;
+	std::streambuf * err;
+public:
+	Silence() : out(std::cout.rdbuf(&sink)), err(std::cerr.rdbuf(&sink)) {}
+	~Silence() { std::cout.rdbuf(out); std::cerr.rdbuf(err); }
+};
+
+// peak resident set in kB, since start or last resetPeakRss()
+auto peakRssKb() -> long {
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.rfind("VmHWM:", 0) == 0)
+			return std::stol(line.substr(6));
+	}
+#if defined(__linux__)
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+#else
+	return 0;
+#endif
+}
+
+auto resetPeakRss() -> void {
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	if (clearRefs) clearRefs << "5";
+}
+
+struct Result {
+	std::string engine;
+	std::vector<std::pair<std::string, std::string>> params;
+	std::uint64_t generations{ 0 };
+	std::uint64_t evaluations{ 0 };
+	std::uint64_t allocations{ 0 };
+	double seconds{ 0.0 };
+	long peakRssKb{ 0 };
+};
+
+// setup() builds engine (not measured), run(engine) evolves given number of generations
+template<typename Setup, typename Run>
+auto measure(Result result, Setup && setup, Run && run) -> Result {
+	resetPeakRss();
+	Silence silence;
+
+	auto engine{ setup() };
+	std::uint64_t before{ allocations.load() };
+	auto start{ std::chrono::steady_clock::now() };
+	run(*engine);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	result.allocations = allocations.load() - before;
+	result.seconds = elapsed.count();
+	result.peakRssKb = peakRssKb();
+	return result;
+}
+
+auto print(const Result & r) -> void {
+	std::ostringstream params;
+	for (const auto & [key, value] : r.params)
+		params << key << '=' << value << ' ';
+
+	std::cout << std::left << std::setw(18) << r.engine << std::setw(56) << params.str() << std::right
+		<< std::fixed << std::setprecision(1)
+		<< std::setw(12) << r.generations / r.seconds
+		<< std::setw(14) << r.evaluations / r.seconds
+		<< std::setw(12) << static_cast<double>(r.allocations) / r.generations
+		<< std::setw(12) << r.peakRssKb << '\n';
+}
+
+auto writeJson(std::ostream & file, const std::vector<Result> & results) -> void {
+	file << "{\n  \"benchmark\": \"engine_benchmark\",\n  \"version\": 1,\n  \"results\": [\n";
+	for (std::size_t i = 0; i < results.size(); i++) {
+		const Result & r{ results[i] };
+		file << "    {\"engine\": \"" << r.engine << "\", \"params\": {";
+		for (std::size_t p = 0; p < r.params.size(); p++)
+			file << (p ? ", " : "") << '"' << r.params[p].first << "\": \"" << r.params[p].second << '"';
+		file << "}, \"generations\": " << r.generations
+			<< ", \"evaluations\": " << r.evaluations
+			<< ", \"seconds\": " << std::setprecision(9) << r.seconds
+			<< ", \"generationsPerSec\": " << r.generations / r.seconds
+			<< ", \"evaluationsPerSec\": " << r.evaluations / r.seconds
+			<< ", \"allocationsPerGeneration\": " << static_cast<double>(r.allocations) / r.generations
+			<< ", \"peakRssKb\": " << r.peakRssKb << '}'
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "  ]\n}\n";
+}
+
+auto selectName(SelectMethod m) -> std::string {
+	switch (m) {
+	case SelectMethod::ROULETTE: return "ROULETTE";
+	case SelectMethod::DETERMINISTIC: return "DETERMINISTIC";
+	case SelectMethod::TRUNCATION: return "TRUNCATION";
+	case SelectMethod::SUS: return "SUS";
+	}
+	return "UNKNOWN";
+}
+
+auto scalingName(ScalingType s) -> std::string {
+	switch (s) {
+	case ScalingType::NONE: return "NONE";
+	case ScalingType::LINEAR: return "LINEAR";
+	}
+	return "UNKNOWN";
+}
+
+// obstacles scattered over Pathfinder area, away from start and destination
+auto makeObstacles(std::size_t count, const geo::Circle & start, const geo::Point & dest) -> std::vector<geo::Circle> {
+	CounterRng rng{ 2024u, 0, static_cast<std::uint32_t>(count), RngOp::INIT };
+	std::uniform_real_distribution<double> xDis(0.0, 1920.0), yDis(0.0, 1000.0), rDis(20.0, 80.0);
+
+	std::vector<geo::Circle> obstacles;
+	while (obstacles.size() < count) {
+		geo::Circle c({ xDis(rng), yDis(rng) }, rDis(rng));
+		if (abs(c.o - start.o) > c.r + start.r && abs(c.o - dest) > c.r + start.r)
+			obstacles.push_back(c);
+	}
+	return obstacles;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	std::string outputPath{ "engine_benchmark.json" };
+	double scale{ 1.0 };
+
+	if (argc > 1) outputPath = argv[1];
+	if (argc > 2) scale = std::stod(argv[2]);
+
+	auto scaled = [scale](int generations) { return std::max(1, static_cast<int>(generations * scale)); };
+
+	std::vector<Result> results;
+	std::cout << std::left << std::setw(18) << "engine" << std::setw(56) << "params" << std::right
+		<< std::setw(12) << "gen/s" << std::setw(14) << "eval/s"
+		<< std::setw(12) << "alloc/gen" << std::setw(12) << "peak kB" << '\n';
+
+	auto add = [&](Result r) {
+		print(r);
+		results.push_back(std::move(r));
+	};
+
+	// SGA: selection x scaling
+	for (SelectMethod select : { SelectMethod::ROULETTE, SelectMethod::DETERMINISTIC, SelectMethod::TRUNCATION, SelectMethod::SUS }) {
+		for (ScalingType scaling : { ScalingType::NONE, ScalingType::LINEAR }) {
+			SGAConfig config;
+			config.seed = 5489u;
+			config.popSize = 1000;
+			config.chromosomeLen = 32;
+			config.maxGenerations = scaled(200);
+			config.selectMethod = select;
+			config.scalingType = scaling;
+
+			Result r{ "SGA", { { "selectMethod", selectName(select) }, { "scalingType", scalingName(scaling) },
+				{ "popSize", std::to_string(config.popSize) } } };
+			r.generations = config.maxGenerations;
+			r.evaluations = r.generations * config.popSize;
+			add(measure(r,
+				[&] { return std::make_unique<SGA<>>(config, [](double x) { return x * x; }); },
+				[](SGA<> & sga) { sga.run(); }));
+		}
+	}
+
+	// GeneticAlgorithm: population sizes
+	for (int popSize : { 50, 500, 5000 }) {
+		GAConfig config;
+		config.seed = 20u;
+		config.popSize = popSize;
+		int generations{ scaled(200000 / popSize) };
+
+		Result r{ "GeneticAlgorithm", { { "popSize", std::to_string(popSize) } } };
+		r.generations = generations;
+		r.evaluations = r.generations * popSize;
+		add(measure(r,
+			[&] { return std::make_unique<GeneticAlgorithm<>>(config); },
+			[generations](GeneticAlgorithm<> & ga) { ga.evolve(generations); }));
+	}
+
+	// GAP: game length, every generation plays popSize * (popSize - 1) / 2 games
+	for (std::size_t gameRounds : { 50, 150, 500 }) {
+		gap::GAPConfig config;
+		config.seed = 20u;
+		config.gameRounds = gameRounds;
+		int generations{ scaled(20) };
+
+		Result r{ "GAP", { { "gameRounds", std::to_string(gameRounds) }, { "popSize", std::to_string(config.popSize) } } };
+		r.generations = generations;
+		r.evaluations = r.generations * config.popSize * (config.popSize - 1) / 2;
+		add(measure(r,
+			[&] { return std::make_unique<gap::GAP<>>(config); },
+			[generations](gap::GAP<> & gap) { gap.evolve(generations); }));
+	}
+
+	// Pathfinder: obstacle counts, population of 100 paths
+	for (std::size_t count : { 5, 20, 50, 100 }) {
+		geo::Circle queen({ 417, 750 }, 30.0);
+		geo::Point dest{ 1700, 200 };
+		std::vector<geo::Circle> sites{ makeObstacles(count, queen, dest) };
+		int generations{ scaled(100) };
+
+		Result r{ "Pathfinder", { { "obstacles", std::to_string(count) } } };
+		r.generations = generations;
+		r.evaluations = r.generations * 100;
+		add(measure(r,
+			[&] {
+				Pathfinder & pathfinder{ Pathfinder::getPathfinder() };
+				pathfinder.setSeed(2024u);
+				return &pathfinder;
+			},
+			[&](Pathfinder & pathfinder) { pathfinder.findBestPath(queen, dest, sites, generations); }));
+	}
+
+	std::ofstream file(outputPath);
+	if (!file) {
+		std::cerr << "Benchmark Error! Cannot open " << outputPath << '\n';
+		return 1;
+	}
+	writeJson(file, results);
+	std::cout << "results written to " << outputPath << '\n';
+	return 0;
+}
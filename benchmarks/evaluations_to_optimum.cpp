@@ -0,0 +1,232 @@
+/* Evaluations To Optimum Benchmark
+*
+* Ground truth first: every genotype of the SGA problem (x^2 over 10 bits)
+* and of the sine problem (x sin(10 pi x) + 1 over 22 bits) is evaluated
+* in parallel, GAP strategy space is only sampled (scored against a fixed
+* panel of random opponents, so it is a lower bound).
+*
+* Then every SelectMethod x ScalingType of SGA, and GeneticAlgorithm on
+* sine, run over many seeds until their population holds the true optimum
+* or the generation limit is hit. Table shows share of seeds that reached
+* it, fitness evaluations and wall time per seed that it took (quantiles
+* over seeds that reached it).
+*
+* SGA runs sine shifted by +1 more, so every fitness stays positive for
+* roulette and scaling; argmax is the same.
+*
+* build: cmake --build build --target evaluations_to_optimum
+* usage: evaluations_to_optimum [seeds] [maxGenerations] [popSize] [threads] [gapSamples]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+#include "../genetic_sine_maximum/GA.h"
+#include "../genetic_prisoners_dilemma/GAP.h"
+#include "../common/Oracle.h"
+#include "../common/SeedSweep.h"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double pi{ 3.14159265358979323846 };
+constexpr int sineBits{ 22 };
+
+// same operations as GeneticAlgorithm::castChrom and evalChrom
+auto sine(double value) -> double {
+	double x{ -1.0 + (value * 3.0) / std::ldexp(1.0, sineBits) };
+	return x * std::sin(10 * pi * x) + 1.0;
+}
+
+auto square(double value) -> double { return value * value; }
+
+struct Attempt {
+	bool reached{ false };
+	std::uint64_t evaluations{ 0 };
+	double seconds{ 0.0 };
+};
+
+struct Settings {
+	std::size_t seeds{ 200 };
+	int maxGenerations{ 1000 };
+	int popSize{ 30 };
+	std::size_t threads{ 0 };
+	std::uint64_t gapSamples{ 1 << 14 };
+};
+
+// values that count as the optimum: exact, up to rounding of evaluation path
+auto target(const OracleResult & oracle) -> double {
+	return oracle.best - 1e-12 * std::abs(oracle.best);
+}
+
+auto exhaustive(const char * name, int bits, const std::function<double(double)> & f, ThreadPool & pool) -> OracleResult {
+	auto start{ std::chrono::steady_clock::now() };
+	OracleResult r{ oracle::exhaustive(static_cast<unsigned int>(bits), pool, [&](std::uint64_t first, std::span<double> fitness) {
+		for (std::size_t i = 0; i < fitness.size(); i++) fitness[i] = f(static_cast<double>(first + i));
+	}) };
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	std::cout << std::left << std::setw(22) << name << std::right << std::setprecision(12)
+		<< "  best " << std::setw(16) << r.best << "  at " << std::setw(8) << r.argBest
+		<< "  optima " << r.optima << " of " << r.evaluated
+		<< std::setprecision(3) << "  (" << elapsed.count() * 1e3 << " ms)\n";
+	return r;
+}
+
+// mean score per game of strategy against panel, of GAP games of default length
+auto sampleGap(const Settings & settings, ThreadPool & pool) -> void {
+	using Gap = gap::GAP<>;
+	using strategy_t = Gap::strategy_t;
+	Gap game{ gap::GAPConfig{} };
+	RngStreams streams{ 2024u };
+
+	auto draw = [&](std::uint32_t generation, std::uint32_t index) {
+		strategy_t strategy{};
+		CounterRng rng{ streams(generation, index, RngOp::INIT) };
+		std::bernoulli_distribution flip{ 0.5 };
+		for (bool & move : strategy) move = flip(rng);
+		return strategy;
+	};
+
+	std::vector<strategy_t> panel(32);
+	for (std::size_t k = 0; k < panel.size(); k++) panel[k] = draw(1, static_cast<std::uint32_t>(k));
+
+	auto start{ std::chrono::steady_clock::now() };
+	OracleResult r{ oracle::sampled(settings.gapSamples, pool, [&](std::uint64_t sample) {
+		strategy_t strategy{ draw(0, static_cast<std::uint32_t>(sample)) };
+		double score{ 0.0 };
+		for (const strategy_t & opponent : panel) score += game.playMatch(strategy, opponent).first;
+		return score / static_cast<double>(panel.size());
+	}) };
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	std::cout << std::left << std::setw(22) << "GAP (sampled, >=)" << std::right << std::setprecision(12)
+		<< "  best " << std::setw(16) << r.best << "  at sample " << r.argBest
+		<< "  of " << r.evaluated << " vs panel of " << panel.size()
+		<< std::setprecision(3) << "  (" << elapsed.count() * 1e3 << " ms)\n";
+}
+
+// runs attempt(engine, seed) for every seed on pool, one engine per worker
+template<typename Engine, typename Make, typename Run>
+auto attempts(const Settings & settings, ThreadPool & pool, Make && make, Run && run) -> std::vector<Attempt> {
+	std::vector<Attempt> results(settings.seeds);
+	std::vector<std::unique_ptr<Engine>> engines(pool.size());
+	pool.parallelFor(settings.seeds, Schedule::WORK_STEALING, 1, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+		if (!engines[worker]) engines[worker] = make();
+		for (std::size_t i = begin; i < end; i++) {
+			auto start{ std::chrono::steady_clock::now() };
+			results[i] = run(*engines[worker], 1u + static_cast<unsigned int>(i));
+			std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+			results[i].seconds = elapsed.count();
+		}
+	});
+	return results;
+}
+
+auto printRow(const std::string & problem, const std::string & method, const std::vector<Attempt> & results) -> void {
+	std::vector<double> evaluations, millis;
+	for (const Attempt & a : results) {
+		if (!a.reached) continue;
+		evaluations.push_back(static_cast<double>(a.evaluations));
+		millis.push_back(a.seconds * 1e3);
+	}
+	std::sort(evaluations.begin(), evaluations.end());
+	std::sort(millis.begin(), millis.end());
+
+	std::cout << std::left << std::setw(8) << problem << std::setw(28) << method << std::right << std::fixed
+		<< std::setprecision(1) << std::setw(9) << 100.0 * evaluations.size() / results.size() << '%'
+		<< std::setprecision(0) << std::setw(12) << sweep::quantile(evaluations, 0.5)
+		<< std::setw(12) << sweep::quantile(evaluations, 0.9)
+		<< std::setprecision(3) << std::setw(12) << sweep::quantile(millis, 0.5)
+		<< std::setw(12) << sweep::quantile(millis, 0.9) << '\n' << std::defaultfloat;
+}
+
+auto selectName(SelectMethod method) -> const char * {
+	switch (method) {
+	case SelectMethod::ROULETTE: return "ROULETTE";
+	case SelectMethod::DETERMINISTIC: return "DETERMINISTIC";
+	case SelectMethod::TRUNCATION: return "TRUNCATION";
+	case SelectMethod::SUS: return "SUS";
+	}
+	return "?";
+}
+
+auto runSga(const Settings & settings, ThreadPool & pool, const std::string & problem, int bits,
+	std::function<double(double)> f, double goal) -> void {
+	for (SelectMethod select : { SelectMethod::ROULETTE, SelectMethod::DETERMINISTIC, SelectMethod::TRUNCATION, SelectMethod::SUS }) {
+		for (ScalingType scaling : { ScalingType::NONE, ScalingType::LINEAR }) {
+			SGAConfig config;
+			config.popSize = settings.popSize;
+			config.maxGenerations = settings.maxGenerations;
+			config.chromosomeLen = bits;
+			config.selectMethod = select;
+			config.scalingType = scaling;
+
+			auto make = [&] { return std::make_unique<SGA<>>(config, f); };
+			auto run = [&](SGA<> & sga, unsigned int seed) {
+				sga.reseed(seed);
+				SGAStats stats{ sga.stats() };
+				while (stats.rawMaxFitness < goal && stats.generations < settings.maxGenerations) {
+					sga.step();
+					stats = sga.stats();
+				}
+				return Attempt{ stats.rawMaxFitness >= goal, stats.evaluations };
+			};
+
+			std::string method{ std::string(selectName(select)) + (scaling == ScalingType::LINEAR ? " + LINEAR" : "") };
+			printRow(problem, method, attempts<SGA<>>(settings, pool, make, run));
+		}
+	}
+}
+
+auto runGa(const Settings & settings, ThreadPool & pool, double goal) -> void {
+	GAConfig config;
+	config.popSize = settings.popSize + settings.popSize % 2;
+	config.chromLen = sineBits;
+
+	auto make = [&] { return std::make_unique<GeneticAlgorithm<>>(config); };
+	auto run = [&](GeneticAlgorithm<> & ga, unsigned int seed) {
+		ga.reseed(seed);
+		ga.step(0);
+		GAStats stats{ ga.stats() };
+		while (stats.max < goal && stats.generation < settings.maxGenerations) {
+			ga.step();
+			stats = ga.stats();
+		}
+		return Attempt{ stats.max >= goal, stats.evaluations };
+	};
+	printRow("sine", "GeneticAlgorithm (ROULETTE)", attempts<GeneticAlgorithm<>>(settings, pool, make, run));
+}
+
+}
+
+int main(int argc, char ** argv) {
+	Settings settings;
+	if (argc > 1) settings.seeds = std::stoul(argv[1]);
+	if (argc > 2) settings.maxGenerations = std::stoi(argv[2]);
+	if (argc > 3) settings.popSize = std::stoi(argv[3]);
+	if (argc > 4) settings.threads = std::stoul(argv[4]);
+	if (argc > 5) settings.gapSamples = std::stoull(argv[5]);
+
+	ThreadPool pool(settings.threads);
+	std::cout << "threads: " << pool.size() << "  seeds: " << settings.seeds
+		<< "  popSize: " << settings.popSize << "  maxGenerations: " << settings.maxGenerations << "\n\n";
+
+	OracleResult squareOracle{ exhaustive("SGA x^2 (10 bits)", 10, square, pool) };
+	OracleResult sineOracle{ exhaustive("sine (22 bits)", sineBits, sine, pool) };
+	sampleGap(settings, pool);
+
+	std::cout << '\n' << std::left << std::setw(8) << "problem" << std::setw(28) << "method" << std::right
+		<< std::setw(10) << "reached" << std::setw(12) << "eval 50%" << std::setw(12) << "eval 90%"
+		<< std::setw(12) << "ms 50%" << std::setw(12) << "ms 90%" << '\n';
+
+	runSga(settings, pool, "x^2", 10, square, target(squareOracle));
+	runSga(settings, pool, "sine", sineBits, [](double v) { return sine(v) + 1.0; }, target(sineOracle) + 1.0);
+	runGa(settings, pool, target(sineOracle));
+}
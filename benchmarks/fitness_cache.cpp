@@ -0,0 +1,113 @@
+/* Fitness Cache Benchmark
+*
+* Evolves GeneticAlgorithm with every CacheMode and reports generations/s
+* and hit rate. Best individual has to be the same in every mode.
+* Second part looks up cache directly with an expensive fitness (busy loop),
+* over genotype stream with repeats, as they appear in converged population.
+*
+* build: cmake --build build --target fitness_cache
+* usage: fitness_cache [popSize] [generations] [fitnessMicroseconds]
+*/
+
+#include "../genetic_sine_maximum/GA.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+auto modeName(CacheMode mode) -> std::string {
+	switch (mode) {
+	case CacheMode::NONE: return "NONE";
+	case CacheMode::DENSE: return "DENSE";
+	case CacheMode::HASHED: return "HASHED";
+	case CacheMode::AUTO: return "AUTO";
+	}
+	return "UNKNOWN";
+}
+
+// keeps last line of engine summary (best individual)
+auto evolveGA(const GAConfig & config, int generations, double & seconds) -> std::string {
+	std::ostringstream sink;
+	std::streambuf * out{ std::cout.rdbuf(sink.rdbuf()) };
+	std::ios_base::fmtflags flags{ std::cout.flags() };
+	std::streamsize precision{ std::cout.precision(6) };
+	std::cout.flags(std::ios_base::dec | std::ios_base::skipws);
+
+	auto start{ std::chrono::steady_clock::now() };
+	GeneticAlgorithm<> ga{ config };
+	ga.evolve(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	seconds = elapsed.count();
+
+	std::cout.rdbuf(out);
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+	return sink.str();
+}
+
+auto field(const std::string & summary, const std::string & name) -> std::string {
+	std::size_t begin{ summary.find(name) };
+	if (begin == std::string::npos) return "";
+	return summary.substr(begin, summary.find('\n', begin) - begin);
+}
+
+}
+
+int main(int argc, char ** argv) {
+	int popSize{ 1000 };
+	int generations{ 300 };
+	int fitnessMicros{ 5 };
+
+	if (argc > 1) popSize = std::stoi(argv[1]);
+	if (argc > 2) generations = std::stoi(argv[2]);
+	if (argc > 3) fitnessMicros = std::stoi(argv[3]);
+
+	std::string reference;
+	for (CacheMode mode : { CacheMode::NONE, CacheMode::DENSE, CacheMode::HASHED }) {
+		GAConfig config;
+		config.popSize = popSize;
+		config.cache.mode = mode;
+
+		double seconds{ 0.0 };
+		std::string summary{ evolveGA(config, generations, seconds) };
+		std::string best{ field(summary, "genotype:") };
+		if (reference.empty()) reference = best;
+
+		std::cout << std::left << std::setw(8) << modeName(mode) << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(12) << generations / seconds << " gen/s  "
+			<< field(summary, "Fitness cache") << "  best " << (best == reference ? "identical" : "DIFFERS") << '\n';
+	}
+
+	// expensive fitness, population of popSize drawn from a few hundred distinct genotypes
+	auto expensive = [fitnessMicros](std::uint64_t key) {
+		auto until{ std::chrono::steady_clock::now() + std::chrono::microseconds(fitnessMicros) };
+		double acc{ static_cast<double>(key) };
+		while (std::chrono::steady_clock::now() < until)
+			acc = acc * 0.5 + 1.0;
+		return static_cast<double>(key) + (acc - acc);
+	};
+
+	for (CacheMode mode : { CacheMode::NONE, CacheMode::DENSE, CacheMode::HASHED }) {
+		CacheConfig config;
+		config.mode = mode;
+		FitnessCache<double> cache(22, config);
+
+		double checksum{ 0.0 };
+		auto start{ std::chrono::steady_clock::now() };
+		for (int g = 0; g < 20; g++) {
+			for (int i = 0; i < popSize; i++) {
+				std::uint64_t key{ (static_cast<std::uint64_t>(i) * 2654435761u + g) % 300 * 13931 };
+				checksum += cache.get(key, [&] { return expensive(key); });
+			}
+		}
+		std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+		std::cout << std::left << std::setw(8) << modeName(mode) << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << elapsed.count() << " s  hits: " << cache.hits() << " misses: " << cache.misses()
+			<< "  checksum: " << std::setprecision(0) << checksum << '\n';
+	}
+}
@@ -0,0 +1,137 @@
+/* Fitness Interface Benchmark
+*
+* Compares three ways of handing fitness function to SGA:
+*	std::function	- scalar, one type erased call per individual
+*	functor			- scalar lambda, inlined into batch loop by SGA::toBatch
+*	batch			- span kernel, AVX2 when compiled with -mavx2
+*
+* First part measures evaluations/s of the fitness call alone, second part
+* measures whole SGA generations/s. Last population has to be the same for all paths.
+*
+* build: g++ -std=c++20 -O2 -mavx2 -pthread fitness_interface.cpp ../simple_genetic_algorithm/SGA.cpp ../common/PackedGenome.cpp
+* usage: fitness_interface [popSize] [generations]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using fitness_t = double;
+using batch_fitness_t = SGA<>::batch_fitness_t;
+
+// cheap polynomial, so that call overhead dominates
+inline auto polynomial(fitness_t x) -> fitness_t {
+	return (0.5 * x + 3.0) * x + 1.0;
+}
+
+auto polynomialBatch(std::span<const fitness_t> x, std::span<fitness_t> fitness) -> void {
+	std::size_t i{ 0 };
+#ifdef __AVX2__
+	const __m256d half{ _mm256_set1_pd(0.5) };
+	const __m256d three{ _mm256_set1_pd(3.0) };
+	const __m256d one{ _mm256_set1_pd(1.0) };
+	for (; i + 4 <= x.size(); i += 4) {
+		__m256d v{ _mm256_loadu_pd(x.data() + i) };
+		__m256d r{ _mm256_add_pd(_mm256_mul_pd(half, v), three) };
+		r = _mm256_add_pd(_mm256_mul_pd(r, v), one);
+		_mm256_storeu_pd(fitness.data() + i, r);
+	}
+#endif
+	for (; i < x.size(); i++)
+		fitness[i] = polynomial(x[i]);
+}
+
+template<typename Eval>
+auto measureCalls(const std::string & name, const std::vector<fitness_t> & x, std::vector<fitness_t> & out,
+	int repeats, Eval && eval) -> void {
+
+	auto start{ std::chrono::steady_clock::now() };
+	for (int r = 0; r < repeats; r++) eval();
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	std::cout << std::left << std::setw(16) << name
+		<< std::right << std::setw(14) << std::fixed << std::setprecision(1)
+		<< x.size() * repeats / elapsed.count() / 1e6 << " M eval/s"
+		<< "  checksum: " << std::setprecision(6) << out[out.size() / 2] << '\n';
+}
+
+template<typename Make>
+auto measureRun(const std::string & name, int generations, SGAStats & reference, Make && make) -> void {
+	auto start{ std::chrono::steady_clock::now() };
+	auto sga{ make() };
+	sga.run();
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	SGAStats stats{ sga.stats() };
+	if (reference.generations == 0) reference = stats;
+	bool identical{ std::memcmp(&stats.sumFitness, &reference.sumFitness, sizeof(double)) == 0
+		&& std::memcmp(&stats.maxFitness, &reference.maxFitness, sizeof(double)) == 0 };
+
+	std::cout << std::left << std::setw(16) << name
+		<< std::right << std::setw(14) << std::fixed << std::setprecision(1)
+		<< generations / elapsed.count() << " gen/s"
+		<< "  stats " << (identical ? "identical" : "DIFFER") << '\n';
+}
+
+int main(int argc, char ** argv) {
+	int popSize{ 100000 };
+	int generations{ 50 };
+
+	if (argc > 1) popSize = std::stoi(argv[1]);
+	if (argc > 2) generations = std::stoi(argv[2]);
+
+	std::function<fitness_t(fitness_t)> erased{ polynomial };
+	auto functor = [](fitness_t x) { return polynomial(x); };
+
+	// fitness calls alone, in chunks of SGAConfig::grain like inside SGA
+	{
+		constexpr int repeats{ 20 };
+		const std::size_t grain{ SGAConfig{}.grain };
+		std::vector<fitness_t> x(popSize), out(popSize);
+		for (int i = 0; i < popSize; i++) x[i] = i;
+
+		batch_fitness_t inlined{ SGA<>::toBatch(functor) };
+		batch_fitness_t batch{ SGA<>::toBatch(polynomialBatch) };
+
+		auto chunked = [&](batch_fitness_t & f) {
+			for (std::size_t i = 0; i < x.size(); i += grain) {
+				std::size_t n{ std::min(grain, x.size() - i) };
+				f(std::span<const fitness_t>(x.data() + i, n), std::span<fitness_t>(out.data() + i, n));
+			}
+		};
+
+		measureCalls("std::function", x, out, repeats, [&] {
+			for (std::size_t i = 0; i < x.size(); i++) out[i] = erased(x[i]);
+		});
+		measureCalls("functor", x, out, repeats, [&] { chunked(inlined); });
+		measureCalls("batch", x, out, repeats, [&] { chunked(batch); });
+	}
+
+	// whole evolution
+	SGAConfig config;
+	config.seed = 5489u;
+	config.maxGenerations = generations;
+	config.popSize = popSize;
+	config.chromosomeLen = 32;
+	config.scalingType = ScalingType::LINEAR;
+
+	SGAStats reference{};
+	measureRun("std::function", generations, reference, [&] { return SGA<>{ config, erased }; });
+	measureRun("functor", generations, reference, [&] { return SGA<>{ config, functor }; });
+	measureRun("batch", generations, reference, [&] { return SGA<>{ config, batch_fitness_t{ polynomialBatch } }; });
+
+#ifdef __AVX2__
+	std::cout << "batch kernel: AVX2\n";
+#else
+	std::cout << "batch kernel: scalar fallback\n";
+#endif
+}
@@ -0,0 +1,102 @@
+/* Game Cache Benchmark
+*
+* GAP generations without game cache, then with caches of growing
+* capacity. Cached tournament plays every pair of distinct strategies
+* once and weights scores by copies, games already played in earlier
+* generations come from the cache. Shows time, hit rate and distinct
+* strategies of last population, and checks that population stats are
+* bit-identical to the uncached run.
+*
+* Lower pMut keeps more strategies alive between generations, so more
+* games are reused. Lookup is a random access to a large table, so it
+* pays off against KERNEL games of many rounds, not against CYCLE games
+* that cost about as much as the lookup; both modes are measured.
+*
+* build: cmake --build build --target game_cache
+* usage: game_cache [popSize] [generations] [pMut] [gameRounds]
+*/
+
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Outcome {
+	double seconds{ 0.0 };
+	gap::GAPStats stats;
+	gap::GameCacheStats cache;
+};
+
+auto run(gap::GAPConfig config, std::size_t capacity, int generations) -> Outcome {
+	config.gameCache = capacity;
+	gap::GAP<> game{ config };
+
+	auto start{ std::chrono::steady_clock::now() };
+	game.step(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	return Outcome{ elapsed.count(), game.stats(), game.gameCacheStats() };
+}
+
+auto sameBits(double a, double b) -> bool {
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// one table of capacities for game mode of config, true when all match the uncached run
+auto measureMode(const gap::GAPConfig & config, const std::vector<std::size_t> & capacities, int generations) -> bool {
+	std::cout << '\n' << (config.game == gap::GameMode::KERNEL ? "KERNEL" : "CYCLE") << " games\n";
+	std::cout << std::setw(12) << "capacity" << std::setw(12) << "seconds" << std::setw(10) << "speedup"
+		<< std::setw(12) << "hit rate" << std::setw(12) << "evictions" << std::setw(10) << "distinct" << '\n';
+
+	Outcome first{};
+	bool identical{ true };
+	for (std::size_t capacity : capacities) {
+		Outcome o{ run(config, capacity, generations) };
+		if (capacity == 0) first = o;
+		identical = identical && sameBits(o.stats.sum, first.stats.sum) && sameBits(o.stats.max, first.stats.max)
+			&& sameBits(o.stats.min, first.stats.min);
+
+		std::uint64_t lookups{ o.cache.hits + o.cache.misses };
+		std::cout << std::setw(12) << (capacity == 0 ? std::string("off") : std::to_string(capacity))
+			<< std::fixed << std::setprecision(3) << std::setw(12) << o.seconds
+			<< std::setprecision(2) << std::setw(9) << first.seconds / o.seconds << 'x';
+		if (capacity == 0) std::cout << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(10) << "-";
+		else std::cout << std::setw(11) << 100.0 * o.cache.hits / std::max<std::uint64_t>(lookups, 1) << '%'
+			<< std::setw(12) << o.cache.evictions << std::setw(10) << o.stats.distinct;
+		std::cout << '\n' << std::defaultfloat;
+	}
+	return identical;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	gap::GAPConfig config;
+	config.popSize = 1000;
+	config.pMut = 0.001;
+	int generations{ 20 };
+
+	if (argc > 1) config.popSize = std::stoul(argv[1]);
+	if (argc > 2) generations = std::stoi(argv[2]);
+	if (argc > 3) config.pMut = std::stod(argv[3]);
+	if (argc > 4) config.gameRounds = std::stoul(argv[4]);
+
+	std::size_t games{ config.popSize * (config.popSize - 1) / 2 };
+	std::vector<std::size_t> capacities{ 0, games / 4, games, 4 * games, 16 * games };
+
+	std::cout << "popSize: " << config.popSize << "  generations: " << generations
+		<< "  pMut: " << config.pMut << "  gameRounds: " << config.gameRounds << '\n';
+
+	bool identical{ true };
+	for (gap::GameMode mode : { gap::GameMode::KERNEL, gap::GameMode::CYCLE }) {
+		config.game = mode;
+		identical = measureMode(config, capacities, generations) && identical;
+	}
+	std::cout << "identical to uncached: " << (identical ? "yes" : "NO") << '\n';
+	return identical ? 0 : 1;
+}
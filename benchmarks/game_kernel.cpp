@@ -0,0 +1,137 @@
+/* Game Kernel Benchmark
+*
+* Games per second of GAP::playGame (round vectors, SIMULATE mode) against
+* the 6-bit history register kernel (KERNEL mode), on the same random
+* strategy pairs. Kernel is measured through GAP::playMatch (packs both
+* strategies every game) and on strategies packed once, as tournament
+* plays them. Scores of all three have to match.
+*
+* Cycle detecting kernel (CYCLE mode) is measured the same way, then both
+* kernels play games of growing length: simulated cost grows with rounds,
+* cycle kernel stays flat. Its scores are checked against the kernel for
+* every length from 0 to 300 rounds.
+*
+* build: cmake --build build --target game_kernel
+* usage: game_kernel [games] [gameRounds]
+*/
+
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Gap = gap::GAP<>;
+using strategy_t = Gap::strategy_t;
+
+struct Outcome {
+	double seconds{ 0.0 };
+	std::uint64_t checksum{ 0 };	// sum of both scores over all games
+};
+
+template<typename Play>
+auto measure(std::size_t games, Play && play) -> Outcome {
+	Outcome outcome;
+	auto start{ std::chrono::steady_clock::now() };
+	for (std::size_t g = 0; g < games; g++) outcome.checksum += play(g);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	outcome.seconds = elapsed.count();
+	return outcome;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	std::size_t games{ 200000 };
+	std::size_t gameRounds{ 150 };
+	if (argc > 1) games = std::stoul(argv[1]);
+	if (argc > 2) gameRounds = std::stoul(argv[2]);
+
+	// 256 random strategies, game g pairs strategy g mod 256 with (g * 7 + 1) mod 256
+	constexpr std::size_t nStrategies{ 256 };
+	std::vector<strategy_t> strategies(nStrategies);
+	std::vector<gap::PackedStrategy> packed(nStrategies);
+	RngStreams streams{ 7u };
+	std::bernoulli_distribution flip{ 0.5 };
+	for (std::size_t i = 0; i < nStrategies; i++) {
+		CounterRng rng{ streams(0, static_cast<std::uint32_t>(i), RngOp::INIT) };
+		for (bool & move : strategies[i]) move = flip(rng);
+		packed[i] = gap::kernel::pack(strategies[i]);
+	}
+	auto first = [](std::size_t g) { return g % nStrategies; };
+	auto second = [](std::size_t g) { return (g * 7 + 1) % nStrategies; };
+
+	gap::GAPConfig config;
+	config.gameRounds = gameRounds;
+	config.game = gap::GameMode::SIMULATE;
+	Gap simulate{ config };
+	config.game = gap::GameMode::KERNEL;
+	Gap kernel{ config };
+
+	auto total = [](std::pair<double, double> score) { return static_cast<std::uint64_t>(score.first + score.second); };
+
+	Outcome reference{ measure(games, [&](std::size_t g) {
+		return total(simulate.playMatch(strategies[first(g)], strategies[second(g)]));
+	}) };
+	Outcome match{ measure(games, [&](std::size_t g) {
+		return total(kernel.playMatch(strategies[first(g)], strategies[second(g)]));
+	}) };
+	Outcome prepacked{ measure(games, [&](std::size_t g) {
+		gap::GameScore score{ gap::kernel::play(packed[first(g)], packed[second(g)], gameRounds) };
+		return score.first + score.second;
+	}) };
+	Outcome cycle{ measure(games, [&](std::size_t g) {
+		gap::GameScore score{ gap::kernel::playCycle(packed[first(g)], packed[second(g)], gameRounds) };
+		return score.first + score.second;
+	}) };
+
+	std::cout << "games: " << games << "  rounds per game: " << gameRounds << '\n';
+	std::cout << std::left << std::setw(28) << "" << std::right << std::setw(16) << "games/s" << std::setw(12) << "speedup" << '\n';
+	auto row = [&](const char * name, const Outcome & o) {
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(16) << games / o.seconds << std::setprecision(2)
+			<< std::setw(11) << reference.seconds / o.seconds << 'x' << '\n' << std::defaultfloat;
+	};
+	row("playGame (SIMULATE)", reference);
+	row("playMatch (KERNEL)", match);
+	row("kernel, packed once", prepacked);
+	row("cycle kernel, packed once", cycle);
+
+	bool same{ reference.checksum == match.checksum && reference.checksum == prepacked.checksum
+		&& reference.checksum == cycle.checksum };
+
+	for (std::size_t rounds = 0; rounds <= 300; rounds++) {
+		for (std::size_t g = 0; g < nStrategies; g++) {
+			gap::GameScore simulated{ gap::kernel::play(packed[first(g)], packed[second(g)], rounds) };
+			gap::GameScore closed{ gap::kernel::playCycle(packed[first(g)], packed[second(g)], rounds) };
+			same = same && simulated.first == closed.first && simulated.second == closed.second;
+		}
+	}
+	std::cout << "scores match: " << (same ? "yes" : "NO") << "\n\n";
+
+	// fewer games for long ones, simulated kernel would take minutes at 10^6 rounds
+	std::cout << std::left << std::setw(12) << "rounds" << std::right << std::setw(18) << "kernel games/s"
+		<< std::setw(18) << "cycle games/s" << '\n';
+	for (std::size_t rounds : { 150, 1000, 10000, 100000, 1000000 }) {
+		std::size_t n{ std::max<std::size_t>(games * 150 / rounds, 256) };
+		Outcome simulated{ measure(n, [&](std::size_t g) {
+			gap::GameScore score{ gap::kernel::play(packed[first(g)], packed[second(g)], rounds) };
+			return score.first + score.second;
+		}) };
+		Outcome closed{ measure(n, [&](std::size_t g) {
+			gap::GameScore score{ gap::kernel::playCycle(packed[first(g)], packed[second(g)], rounds) };
+			return score.first + score.second;
+		}) };
+		same = same && simulated.checksum == closed.checksum;
+		std::cout << std::left << std::setw(12) << rounds << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(18) << n / simulated.seconds << std::setw(18) << n / closed.seconds << '\n' << std::defaultfloat;
+	}
+	std::cout << "long games match: " << (same ? "yes" : "NO") << '\n';
+	return same ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/* Island Model Benchmark
+*
+* One GeneticAlgorithm of K * popSize individuals against K islands of
+* popSize individuals (ring and random topology), same number of generations.
+* Reports wall time, best fitness found and average of island averages,
+* over several seeds. Every island run is repeated to check that result
+* does not depend on thread timing.
+*
+* build: cmake --build build --target island_model
+* usage: island_model [islands] [popSize] [generations] [seeds]
+*/
+
+#include "../genetic_sine_maximum/IslandModel.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Outcome {
+	double seconds{ 0.0 };
+	double best{ 0.0 };
+	double avg{ 0.0 };
+};
+
+auto runSingle(GAConfig config, std::size_t islands, int generations) -> Outcome {
+	config.popSize *= static_cast<int>(islands);
+
+	auto start{ std::chrono::steady_clock::now() };
+	GeneticAlgorithm<> ga{ config };
+	ga.step(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	GAStats stats{ ga.stats() };
+	return Outcome{ elapsed.count(), stats.best.fitness, stats.avg };
+}
+
+auto runIslands(const IslandConfig & config, int generations, bool & deterministic) -> Outcome {
+	auto start{ std::chrono::steady_clock::now() };
+	IslandModel model{ config };
+	model.evolve(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	IslandModel again{ config };
+	again.evolve(generations);
+	std::ostringstream a, b;
+	a << model;
+	b << again;
+	deterministic = deterministic && a.str() == b.str();
+
+	double avg{ 0.0 };
+	for (std::size_t i = 0; i < model.size(); i++) avg += model.stats(i).ga.avg;
+	return Outcome{ elapsed.count(), model.globalBest().fitness, avg / model.size() };
+}
+
+}
+
+int main(int argc, char ** argv) {
+	std::size_t islands{ std::max(2u, std::thread::hardware_concurrency()) };
+	int popSize{ 50 };
+	int generations{ 500 };
+	int seeds{ 10 };
+
+	if (argc > 1) islands = std::stoul(argv[1]);
+	if (argc > 2) popSize = std::stoi(argv[2]);
+	if (argc > 3) generations = std::stoi(argv[3]);
+	if (argc > 4) seeds = std::stoi(argv[4]);
+
+	Outcome single{}, ring{}, random{};
+	bool deterministic{ true };
+
+	for (int s = 0; s < seeds; s++) {
+		GAConfig ga;
+		ga.seed = 100u + 97u * s;
+		ga.popSize = popSize;
+
+		auto add = [](Outcome & sum, const Outcome & o) {
+			sum.seconds += o.seconds;
+			sum.best += o.best;
+			sum.avg += o.avg;
+		};
+
+		add(single, runSingle(ga, islands, generations));
+
+		IslandConfig config;
+		config.ga = ga;
+		config.islands = islands;
+		config.topology = Topology::RING;
+		add(ring, runIslands(config, generations, deterministic));
+
+		config.topology = Topology::RANDOM;
+		add(random, runIslands(config, generations, deterministic));
+	}
+
+	auto print = [&](const std::string & name, const Outcome & o) {
+		std::cout << std::left << std::setw(26) << name << std::right << std::fixed
+			<< std::setprecision(3) << std::setw(9) << o.seconds / seeds << " s"
+			<< "  best: " << std::setprecision(6) << o.best / seeds
+			<< "  avg: " << o.avg / seeds << '\n';
+	};
+
+	std::cout << "islands: " << islands << "  popSize: " << popSize << "  generations: " << generations
+		<< "  seeds: " << seeds << "  (means over seeds)\n";
+	print("single population x" + std::to_string(islands), single);
+	print("islands ring", ring);
+	print("islands random", random);
+	std::cout << "island results " << (deterministic ? "repeatable" : "NOT repeatable") << '\n';
+}
@@ -0,0 +1,70 @@
+/* Parallel Fitness Benchmark
+*
+* Runs SGA with an artificially expensive fitness function on 1..N threads,
+* for both schedules, and reports speedup over single thread.
+* Statistics of last population have to be bit-identical for every run.
+*
+* build: g++ -std=c++20 -O2 -pthread parallel_fitness.cpp ../simple_genetic_algorithm/SGA.cpp ../common/PackedGenome.cpp
+* usage: parallel_fitness [maxThreads] [fitnessMicroseconds]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char ** argv) {
+	std::size_t maxThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+	int fitnessMicros{ 50 };
+
+	if (argc > 1) maxThreads = std::stoul(argv[1]);
+	if (argc > 2) fitnessMicros = std::stoi(argv[2]);
+
+	// busy loop standing for expensive user fitness, result depends only on x
+	auto expensive = [fitnessMicros](double x) {
+		auto until{ std::chrono::steady_clock::now() + std::chrono::microseconds(fitnessMicros) };
+		double acc{ x };
+		while (std::chrono::steady_clock::now() < until)
+			acc = acc * 0.5 + 1.0;
+		return x * x + (acc - acc);
+	};
+
+	SGAConfig config;
+	config.seed = 5489u;
+	config.maxGenerations = 20;
+	config.popSize = 1000;
+	config.chromosomeLen = 32;
+	config.scalingType = ScalingType::LINEAR;
+
+	double baseline{ 0.0 };
+	SGAStats reference{};
+
+	for (Schedule schedule : { Schedule::STATIC, Schedule::WORK_STEALING }) {
+		for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+			config.threads = threads;
+			config.schedule = schedule;
+
+			auto start{ std::chrono::steady_clock::now() };
+			SGA<> sga{ config, expensive };
+			sga.run();
+			std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+			SGAStats stats{ sga.stats() };
+			if (baseline == 0.0) {
+				baseline = elapsed.count();
+				reference = stats;
+			}
+			bool identical{ std::memcmp(&stats.sumFitness, &reference.sumFitness, sizeof(double)) == 0
+				&& std::memcmp(&stats.maxFitness, &reference.maxFitness, sizeof(double)) == 0 };
+
+			std::cout << (schedule == Schedule::STATIC ? "static  " : "stealing")
+				<< "  threads: " << std::setw(3) << threads
+				<< "  time: " << std::fixed << std::setprecision(3) << elapsed.count() << "s"
+				<< "  speedup: " << std::setprecision(2) << baseline / elapsed.count()
+				<< "  stats " << (identical ? "identical" : "DIFFER") << '\n';
+		}
+	}
+}
@@ -0,0 +1,162 @@
+/* Population Statistics Benchmark
+*
+* Per-generation statistics stage of SGA, before and after fusing:
+*	multi-pass	- previous stage, individuals walked by writeback, calculateStatistics,
+*				  updateIndividuals, resetIDs, scaleLinear, calculateStatistics,
+*				  updateIndividuals and resetIDs again
+*	fused		- summarize and scaleLinear over contiguous fitness array,
+*				  then single writeback of fitness, expected copies and ID
+* Both stages have to give the same scaled fitness. Last column is whole
+* SGA generations/s with cheap fitness, where this stage matters most.
+*
+* build: g++ -std=c++20 -O2 -pthread population_stats.cpp ../simple_genetic_algorithm/SGA.cpp ../common/PackedGenome.cpp
+* usage: population_stats [repeats]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// same layout as SGA::Individual
+struct Individual {
+	PackedGenome genotype;
+	double fitness{ 0.0 };
+	double expectedCopies{ 0.0 };
+	int id{ 0 };
+};
+
+struct Stats {
+	double sum, avg, max, min;
+};
+
+auto multiPassStage(std::vector<Individual> & population, const std::vector<double> & evaluated) -> Stats {
+	Stats s{};
+	auto calculateStatistics = [&] {
+		s.sum = s.avg = 0;
+		s.max = std::numeric_limits<double>::min();
+		s.min = std::numeric_limits<double>::max();
+		for (const Individual & ind : population) {
+			s.sum += ind.fitness;
+			s.max = std::max(s.max, ind.fitness);
+			s.min = std::min(s.min, ind.fitness);
+		}
+		s.avg = s.sum / population.size();
+	};
+	auto updateIndividuals = [&] {
+		for (Individual & ind : population) ind.expectedCopies = ind.fitness / s.avg;
+	};
+	auto resetIDs = [&] {
+		int id{ };
+		for (Individual & ind : population) ind.id = id++;
+	};
+
+	for (std::size_t i = 0; i < population.size(); i++)
+		population[i].fitness = evaluated[i];
+	calculateStatistics();
+	updateIndividuals();
+	resetIDs();
+
+	double multiplier{ 2.0 }, a{ 1.0 }, b{ 0.0 };
+	if (s.min != s.max) {
+		if (s.min > (multiplier * s.avg - s.max) / (multiplier - 1.0)) {
+			double delta{ s.max - s.avg };
+			a = (multiplier - 1.0) * s.avg / delta;
+			b = s.avg * (s.max - multiplier * s.avg) / delta;
+		}
+		else {
+			double delta{ s.avg - s.min };
+			a = s.avg / delta;
+			b = -s.min * s.avg / delta;
+		}
+	}
+	for (Individual & ind : population) ind.fitness = std::fabs(a * ind.fitness + b);
+
+	calculateStatistics();
+	updateIndividuals();
+	resetIDs();
+	return s;
+}
+
+auto fusedStage(std::vector<Individual> & population, std::vector<double> & evaluated) -> Stats {
+	FitnessSummary raw{ stats::summarize(evaluated.data(), evaluated.size()) };
+	FitnessSummary s{ stats::scaleLinear(evaluated.data(), evaluated.data(), evaluated.size(), raw) };
+
+	int id{ };
+	for (std::size_t i = 0; i < population.size(); i++) {
+		population[i].fitness = evaluated[i];
+		population[i].expectedCopies = evaluated[i] / s.avg;
+		population[i].id = id++;
+	}
+	return Stats{ s.sum, s.avg, s.max, s.min };
+}
+
+template<typename Stage>
+auto measure(std::size_t n, int repeats, Stage && stage) -> double {
+	std::vector<Individual> population(n, Individual{ PackedGenome(32) });
+	std::vector<double> source(n), evaluated(n);
+	for (std::size_t i = 0; i < n; i++) source[i] = static_cast<double>((i * 2654435761u) % 100003);
+
+	double checksum{ 0.0 };
+	auto start{ std::chrono::steady_clock::now() };
+	for (int r = 0; r < repeats; r++) {
+		evaluated = source;
+		checksum += stage(population, evaluated).max;
+	}
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	if (checksum <= 0.0) std::cerr << "Benchmark Error! Empty checksum\n";
+	return elapsed.count() / repeats / n * 1e9;
+}
+
+auto sgaGenerations(std::size_t n, int generations) -> double {
+	SGAConfig config;
+	config.seed = 5489u;
+	config.popSize = static_cast<int>(n);
+	config.maxGenerations = generations;
+	config.chromosomeLen = 16;
+	config.scalingType = ScalingType::LINEAR;
+
+	auto start{ std::chrono::steady_clock::now() };
+	SGA<> sga{ config, [](double x) { return x; } };
+	sga.run();
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	return generations / elapsed.count();
+}
+
+int main(int argc, char ** argv) {
+	int repeats{ 200 };
+	if (argc > 1) repeats = std::stoi(argv[1]);
+
+	// same input has to give the same scaled population
+	{
+		std::vector<Individual> before(1000, Individual{ PackedGenome(32) }), after(before);
+		std::vector<double> evaluated(1000);
+		for (std::size_t i = 0; i < evaluated.size(); i++) evaluated[i] = static_cast<double>(i % 37);
+		multiPassStage(before, evaluated);
+		fusedStage(after, evaluated);
+		for (std::size_t i = 0; i < before.size(); i++) {
+			if (std::fabs(before[i].fitness - after[i].fitness) > 1e-9 * std::fabs(before[i].fitness))
+				std::cerr << "Benchmark Error! Stages differ at " << i << '\n';
+		}
+	}
+
+	std::cout << std::setw(10) << "popSize" << std::setw(18) << "multi-pass ns/ind"
+		<< std::setw(14) << "fused ns/ind" << std::setw(10) << "speedup" << std::setw(14) << "SGA gen/s" << '\n';
+
+	for (std::size_t n : { 30, 1000, 100000 }) {
+		int r{ static_cast<int>(std::max<std::size_t>(1, repeats * 1000 / n)) };
+		double before{ measure(n, r, multiPassStage) };
+		double after{ measure(n, r, fusedStage) };
+
+		std::cout << std::setw(10) << n << std::fixed << std::setprecision(2)
+			<< std::setw(18) << before << std::setw(14) << after
+			<< std::setw(10) << before / after
+			<< std::setw(14) << std::setprecision(0) << sgaGenerations(n, static_cast<int>(std::max<std::size_t>(2, 200000 / n))) << '\n';
+	}
+}
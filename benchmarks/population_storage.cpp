@@ -0,0 +1,83 @@
+/* Population Storage Benchmark
+*
+* Compares throughput of compile-time fast paths (population kept in
+* std::array) against dynamic mode (heap, cache aligned) at default sizes.
+* Both modes should evolve the same number of generations per second.
+*
+* build: g++ -std=c++20 -O2 population_storage.cpp ../simple_genetic_algorithm/SGA.cpp
+*        ../genetic_sine_maximum/GA.cpp ../genetic_prisoners_dilemma/GAP.cpp ../common/PackedGenome.cpp
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+#include "../genetic_sine_maximum/GA.h"
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// engines report to std::cout and std::cerr, benchmark silences both
+class Silence {
+	std::ostringstream sink;
+	std::streambuf * out;
+	std::streambuf * err;
+public:
+	Silence() : out(std::cout.rdbuf(sink.rdbuf())), err(std::cerr.rdbuf(sink.rdbuf())) {}
+	~Silence() { std::cout.rdbuf(out); std::cerr.rdbuf(err); }
+};
+
+template<typename Run>
+auto measure(const std::string & name, int generations, int repeats, Run && run) -> void {
+	auto start{ std::chrono::steady_clock::now() };
+	{
+		Silence silence;
+		for (int r = 0; r < repeats; r++) run();
+	}
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	std::cout << std::left << std::setw(24) << name
+		<< std::right << std::setw(14) << std::fixed << std::setprecision(0)
+		<< generations * repeats / elapsed.count() << " gen/s\n";
+}
+
+int main() {
+	constexpr int sgaGenerations{ 2000 };
+	constexpr int gaGenerations{ 2000 };
+	constexpr int gapGenerations{ 20 };
+	constexpr int repeats{ 5 };
+
+	SGAConfig sgaConfig;
+	sgaConfig.seed = 5489u;
+	sgaConfig.maxGenerations = sgaGenerations;
+	auto square = [](double x) { return x * x; };
+
+	measure("SGA<30>", sgaGenerations, repeats, [&] {
+		SGA<SGAConfig::fastPopSize> sga{ sgaConfig, square };
+		sga.evolution();
+	});
+	measure("SGA<dynamic> 30", sgaGenerations, repeats, [&] {
+		SGA<> sga{ sgaConfig, square };
+		sga.evolution();
+	});
+
+	GAConfig gaConfig;
+	measure("GeneticAlgorithm<50>", gaGenerations, repeats, [&] {
+		GeneticAlgorithm<GAConfig::fastPopSize> ga{ gaConfig };
+		ga.evolve(gaGenerations);
+	});
+	measure("GeneticAlgorithm<dyn> 50", gaGenerations, repeats, [&] {
+		GeneticAlgorithm<> ga{ gaConfig };
+		ga.evolve(gaGenerations);
+	});
+
+	gap::GAPConfig gapConfig;
+	measure("GAP<30>", gapGenerations, repeats, [&] {
+		gap::GAP<gap::GAPConfig::fastPopSize> player{ gapConfig };
+		player.evolve(gapGenerations);
+	});
+	measure("GAP<dynamic> 30", gapGenerations, repeats, [&] {
+		gap::GAP<> player{ gapConfig };
+		player.evolve(gapGenerations);
+	});
+}
@@ -0,0 +1,123 @@
+/* Sine Batch Benchmark
+*
+* Scalar decode and evaluation (castChrom + std::sin per chromosome, as in
+* GeneticAlgorithm::decodePop) against batch path (decode to contiguous array,
+* cast, vmath::sin over whole array, as in decodePopBatch).
+* First part measures evaluations/s and largest difference between paths,
+* second part whole GeneticAlgorithm generations/s on both paths.
+*
+* build: cmake --build build --target sine_batch (configure with -DGP_NATIVE=ON for AVX2)
+* usage: sine_batch [popSize] [generations]
+*/
+
+#include "../genetic_sine_maximum/GA.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int chromLen{ 22 };
+constexpr double pi{ 3.14159265358979323846 };
+
+auto scalarPath(const std::vector<PackedGenome> & chroms, std::vector<double> & fitness) -> void {
+	double maxVal{ std::ldexp(1.0, chromLen) };
+	for (std::size_t i = 0; i < chroms.size(); i++) {
+		double x{ -1.0 + (static_cast<double>(chroms[i].toUInt64()) * 3.0) / maxVal };
+		fitness[i] = x * std::sin(10 * pi * x) + 1.0;
+	}
+}
+
+auto batchPath(const std::vector<PackedGenome> & chroms, std::vector<double> & decoded, std::vector<double> & fitness) -> void {
+	double maxVal{ std::ldexp(1.0, chromLen) };
+	std::size_t n{ chroms.size() };
+	for (std::size_t i = 0; i < n; i++)
+		decoded[i] = static_cast<double>(chroms[i].toUInt64());
+	for (std::size_t i = 0; i < n; i++)
+		decoded[i] = -1.0 + (decoded[i] * 3.0) / maxVal;
+	for (std::size_t i = 0; i < n; i++)
+		fitness[i] = 10 * pi * decoded[i];
+	vmath::sin(fitness.data(), fitness.data(), n);
+	for (std::size_t i = 0; i < n; i++)
+		fitness[i] = decoded[i] * fitness[i] + 1.0;
+}
+
+auto evolveGA(const GAConfig & config, int generations, double & seconds) -> std::string {
+	std::ostringstream sink;
+	std::streambuf * out{ std::cout.rdbuf(sink.rdbuf()) };
+
+	auto start{ std::chrono::steady_clock::now() };
+	GeneticAlgorithm<> ga{ config };
+	ga.evolve(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+	seconds = elapsed.count();
+
+	std::cout.rdbuf(out);
+	std::string summary{ sink.str() };
+	std::size_t best{ summary.find("genotype:") };
+	return best == std::string::npos ? "" : summary.substr(best, summary.find(' ', best) - best);
+}
+
+}
+
+int main(int argc, char ** argv) {
+	int popSize{ 1000 };
+	int generations{ 300 };
+
+	if (argc > 1) popSize = std::stoi(argv[1]);
+	if (argc > 2) generations = std::stoi(argv[2]);
+
+	{
+		constexpr int repeats{ 50 };
+		std::vector<PackedGenome> chroms(popSize, PackedGenome(chromLen));
+		for (int i = 0; i < popSize; i++) {
+			CounterRng rng{ 7u, 0, static_cast<std::uint32_t>(i), RngOp::INIT };
+			chroms[i].randomize(rng);
+		}
+		std::vector<double> scalar(popSize), batch(popSize), decoded(popSize);
+
+		auto start{ std::chrono::steady_clock::now() };
+		for (int r = 0; r < repeats; r++) scalarPath(chroms, scalar);
+		std::chrono::duration<double> scalarTime{ std::chrono::steady_clock::now() - start };
+
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; r++) batchPath(chroms, decoded, batch);
+		std::chrono::duration<double> batchTime{ std::chrono::steady_clock::now() - start };
+
+		double maxDiff{ 0.0 };
+		for (int i = 0; i < popSize; i++) maxDiff = std::max(maxDiff, std::fabs(scalar[i] - batch[i]));
+
+		std::cout << std::fixed << std::setprecision(1)
+			<< "scalar decodePop  " << std::setw(10) << popSize * repeats / scalarTime.count() / 1e6 << " M eval/s\n"
+			<< "batch decode+sine " << std::setw(10) << popSize * repeats / batchTime.count() / 1e6 << " M eval/s"
+			<< "  speedup " << std::setprecision(2) << scalarTime.count() / batchTime.count()
+			<< "  max |diff| " << std::scientific << maxDiff << std::fixed << '\n';
+	}
+
+	std::string reference;
+	for (bool batchEval : { false, true }) {
+		GAConfig config;
+		config.popSize = popSize;
+		config.cache.mode = CacheMode::NONE;
+		config.batchEval = batchEval;
+
+		double seconds{ 0.0 };
+		std::string best{ evolveGA(config, generations, seconds) };
+		if (reference.empty()) reference = best;
+
+		std::cout << (batchEval ? "GA batch          " : "GA scalar         ")
+			<< std::setw(10) << std::setprecision(1) << generations / seconds << " gen/s"
+			<< "  best " << (best == reference ? "identical" : "differs") << '\n';
+	}
+
+#ifdef __AVX2__
+	std::cout << "vmath::sin: AVX2\n";
+#else
+	std::cout << "vmath::sin: scalar lanes\n";
+#endif
+}
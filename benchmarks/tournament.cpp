@@ -0,0 +1,83 @@
+/* Tournament Benchmark
+*
+* GAP generations of large populations (round robin of popSize^2 / 2
+* games each) on 1, 2, 4, ... threads up to hardware concurrency. Shows
+* games per second and speedup, and checks that population stats are
+* bit-identical for every thread count.
+*
+* build: cmake --build build --target tournament
+* usage: tournament [popSize] [generations] [tileSize] [gameRounds]
+*/
+
+#include "../genetic_prisoners_dilemma/GAP.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Outcome {
+	double seconds{ 0.0 };
+	std::uint64_t games{ 0 };
+	gap::GAPStats stats;
+};
+
+auto run(gap::GAPConfig config, std::size_t threads, int generations) -> Outcome {
+	config.threads = threads;
+	gap::GAP<> game{ config };
+
+	auto start{ std::chrono::steady_clock::now() };
+	game.step(generations);
+	std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+	gap::GAPStats stats{ game.stats() };
+	return Outcome{ elapsed.count(), stats.games, stats };
+}
+
+auto sameBits(double a, double b) -> bool {
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	gap::GAPConfig config;
+	config.popSize = 4000;
+	int generations{ 2 };
+
+	if (argc > 1) config.popSize = std::stoul(argv[1]);
+	if (argc > 2) generations = std::stoi(argv[2]);
+	if (argc > 3) config.tileSize = std::stoul(argv[3]);
+	if (argc > 4) config.gameRounds = std::stoul(argv[4]);
+
+	std::size_t hardware{ std::max(1u, std::thread::hardware_concurrency()) };
+	std::vector<std::size_t> threadCounts;
+	for (std::size_t t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+	threadCounts.push_back(hardware);
+
+	std::cout << "popSize: " << config.popSize << "  generations: " << generations
+		<< "  tileSize: " << config.tileSize << "  gameRounds: " << config.gameRounds << '\n';
+	std::cout << std::setw(8) << "threads" << std::setw(14) << "seconds" << std::setw(16) << "games/s"
+		<< std::setw(10) << "speedup" << std::setw(18) << "max fitness" << '\n';
+
+	Outcome first{};
+	bool identical{ true };
+	for (std::size_t threads : threadCounts) {
+		Outcome o{ run(config, threads, generations) };
+		if (threads == 1) first = o;
+		identical = identical && sameBits(o.stats.sum, first.stats.sum) && sameBits(o.stats.max, first.stats.max)
+			&& sameBits(o.stats.min, first.stats.min);
+
+		std::cout << std::setw(8) << threads << std::fixed << std::setprecision(3) << std::setw(14) << o.seconds
+			<< std::setprecision(0) << std::setw(16) << o.games / o.seconds
+			<< std::setprecision(2) << std::setw(9) << first.seconds / o.seconds << 'x'
+			<< std::setprecision(6) << std::setw(18) << o.stats.max << '\n' << std::defaultfloat;
+	}
+	std::cout << "identical across thread counts: " << (identical ? "yes" : "NO") << '\n';
+	return identical ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/* Trace Round Trip
+*
+* Runs SGA, GeneticAlgorithm and GAP with genome tracing, reads the trace
+* back through TraceView and traceLocus, and compares genomes of the last
+* traced generation with what the engine prints itself: SGA and GAP
+* whole population, GeneticAlgorithm its best individual. Genome lengths
+* cover one word and several words.
+*
+* build: cmake --build build --target trace_roundtrip
+* usage: trace_roundtrip [directory]
+*/
+
+#include "../simple_genetic_algorithm/SGA.h"
+#include "../genetic_sine_maximum/GA.h"
+#include "../genetic_prisoners_dilemma/GAP.h"
+#include "../common/RunTrace.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// what engine printed to stream while run() ran
+template<typename Run>
+auto capture(std::ostream & stream, Run && run) -> std::string {
+	std::ostringstream out;
+	std::streambuf * old{ stream.rdbuf(out.rdbuf()) };
+	run();
+	stream.rdbuf(old);
+	return out.str();
+}
+
+// every token following marker in text, after last occurrence of section
+auto tokensAfter(const std::string & text, const std::string & section, const std::string & marker) -> std::vector<std::string> {
+	std::vector<std::string> tokens;
+	std::size_t at{ text.rfind(section) };
+	if (at == std::string::npos) return tokens;
+	while ((at = text.find(marker, at)) != std::string::npos) {
+		at += marker.size();
+		std::size_t end{ text.find_first_of(" ,\n", at) };
+		tokens.push_back(text.substr(at, end - at));
+	}
+	return tokens;
+}
+
+struct LastGeneration {
+	bool ok{ false };
+	std::vector<double> fitness;
+	std::vector<std::string> genomes;	// locus 0 first, symbols one / zero
+};
+
+auto readLast(const std::string & path, char one, char zero) -> LastGeneration {
+	LastGeneration last;
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	std::size_t size{ static_cast<std::size_t>(file.tellg()) };
+	std::vector<std::uint64_t> data((size + 7) / 8);
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(size));
+
+	TraceView trace{ reinterpret_cast<const char *>(data.data()), size };
+	if (!trace.good() || !trace.complete() || !trace.hasGenomes() || trace.rows() == 0) return last;
+
+	const TraceHeader & header{ trace.header() };
+	std::size_t popSize{ static_cast<std::size_t>(header.popSize) };
+	std::size_t words{ static_cast<std::size_t>(header.genomeWords) };
+	trace.forEachBlock([&](const auto & block) {
+		std::size_t row{ block.rows - 1 };
+		last.fitness.assign(block.fitness + row * popSize, block.fitness + (row + 1) * popSize);
+		last.genomes.assign(popSize, std::string{});
+		for (std::size_t i = 0; i < popSize; i++) {
+			const std::uint64_t * genome{ block.words + (row * popSize + i) * words };
+			for (std::size_t locus = 0; locus < header.genomeBits; locus++)
+				last.genomes[i] += traceLocus(header, genome, locus) ? one : zero;
+		}
+	});
+	last.ok = true;
+	return last;
+}
+
+auto report(const std::string & name, bool same) -> bool {
+	std::cout << name << ": " << (same ? "match" : "MISMATCH") << '\n';
+	return same;
+}
+
+auto checkSga(const std::string & path, int chromosomeLen) -> bool {
+	SGAConfig config;
+	config.popSize = 12;
+	config.chromosomeLen = chromosomeLen;
+	config.maxGenerations = 5;
+	config.trace.path = path;
+	config.trace.genomes = true;
+
+	std::string printed{ capture(std::cout, [&] {
+		SGA<> sga{ config, [](double x) { return x; } };
+		sga.evolution();
+	}) };
+	LastGeneration last{ readLast(path, '1', '0') };
+	return report("SGA " + std::to_string(chromosomeLen) + " bits",
+		last.ok && last.genomes == tokensAfter(printed, "Population:", "Genotype: "));
+}
+
+auto checkGa(const std::string & path, int chromLen) -> bool {
+	GAConfig config;
+	config.popSize = 12;
+	config.chromLen = chromLen;
+	config.trace.path = path;
+	config.trace.genomes = true;
+
+	std::string printed{ capture(std::cout, [&] {
+		GeneticAlgorithm<> ga{ config };
+		ga.evolve(5);
+	}) };
+	LastGeneration last{ readLast(path, '1', '0') };
+	std::vector<std::string> best{ tokensAfter(printed, "Best Individual:", "genotype:") };
+
+	// printed best has the highest fitness, any traced genome of that fitness may be it
+	bool same{ last.ok && best.size() == 1 };
+	if (same) {
+		double max{ *std::max_element(last.fitness.begin(), last.fitness.end()) };
+		bool found{ false };
+		for (std::size_t i = 0; i < last.genomes.size(); i++)
+			found = found || (last.fitness[i] == max && last.genomes[i] == best[0]);
+		same = found;
+	}
+	return report("GeneticAlgorithm " + std::to_string(chromLen) + " bits", same);
+}
+
+auto checkGap(const std::string & path) -> bool {
+	gap::GAPConfig config;
+	config.popSize = 12;
+	config.trace.path = path;
+	config.trace.genomes = true;
+
+	std::string printed{ capture(std::cerr, [&] {
+		gap::GAP<> game{ config };
+		game.evolve(3);
+	}) };
+	LastGeneration last{ readLast(path, 'C', 'D') };
+	return report("GAP", last.ok && last.genomes == tokensAfter(printed, "PopulationStats:", "Strategy: "));
+}
+
+}
+
+int main(int argc, char ** argv) {
+	std::filesystem::path directory{ argc > 1 ? argv[1] : std::filesystem::temp_directory_path().string() };
+	std::string path{ (directory / "trace_roundtrip.trace").string() };
+
+	bool same{ true };
+	same = checkSga(path, 10) && same;
+	same = checkSga(path, 70) && same;
+	same = checkGa(path, 22) && same;
+	same = checkGa(path, 64) && same;
+	same = checkGap(path) && same;
+	std::filesystem::remove(path);
+
+	std::cout << "trace genomes match engine output: " << (same ? "yes" : "NO") << '\n';
+	return same ? 0 : 1;
+}
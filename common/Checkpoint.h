@@ -0,0 +1,215 @@
+/* Checkpoint
+*
+* Binary snapshot of engine state, written every interval generations
+* and loaded on start when the file exists, so a killed run continues
+* where its last checkpoint was taken.
+*
+* Engines draw all randomness from counter based streams keyed by
+* (seed, generation, individual, operator), so seed and generation are
+* the whole RNG state and continuation is bit-identical.
+*
+* Snapshot is serialized to memory on the generation loop thread, then
+* handed to CheckpointWriter thread, which writes it to "path.tmp" and
+* renames it over path, so a crash never leaves half written checkpoint.
+* When a new snapshot of the same path comes before the previous one is
+* on disk, the older one is dropped instead of stalling the loop. Snapshot
+* of another path waits until the pending one is taken by the writer, so
+* every path gets its latest snapshot.
+*
+* File: magic, format version, engine tag, then engine fields in order
+* they were put, native endianness.
+*/
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct CheckpointConfig {
+	std::string path;			// empty disables checkpoints
+	int interval{ 100 };		// generations between checkpoints
+	bool resume{ true };		// load path on start when it exists
+};
+
+enum class CheckpointEngine : std::uint32_t {
+	SGA = 1, GA = 2, GAP = 3,
+};
+
+// appends trivially copyable values to byte buffer
+class CheckpointOut {
+	std::vector<char> & bytes;
+
+public:
+	static constexpr char magic[8]{ 'G', 'P', 'C', 'H', 'E', 'C', 'K', '\0' };
+	static constexpr std::uint32_t version{ 4 };
+
+	CheckpointOut(std::vector<char> & bytes, CheckpointEngine engine) : bytes(bytes) {
+		bytes.clear();
+		put(magic, sizeof(magic));
+		put(version);
+		put(engine);
+	}
+
+	template<typename T>
+	auto put(const T * values, std::size_t n) -> void {
+		static_assert(std::is_trivially_copyable_v<T>, "checkpoint stores raw bytes");
+		std::size_t at{ bytes.size() };
+		bytes.resize(at + n * sizeof(T));
+		std::memcpy(bytes.data() + at, values, n * sizeof(T));
+	}
+
+	template<typename T>
+	auto put(const T & value) -> void { put(&value, 1); }
+};
+
+// reads values in order they were put, good() turns false on short or foreign file
+class CheckpointIn {
+	std::vector<char> bytes;
+	std::size_t pos{ 0 };
+	bool ok{ false };
+
+public:
+	CheckpointIn(const std::string & path, CheckpointEngine engine) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) return;
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		char magic[sizeof(CheckpointOut::magic)]{};
+		std::uint32_t version{ 0 };
+		CheckpointEngine tag{};
+		ok = true;
+		get(magic, sizeof(magic));
+		get(version);
+		get(tag);
+		ok = ok && std::memcmp(magic, CheckpointOut::magic, sizeof(magic)) == 0
+			&& version == CheckpointOut::version && tag == engine;
+	}
+
+	auto good() const -> bool { return ok; }
+	// every byte was read, nothing left over
+	auto complete() const -> bool { return ok && pos == bytes.size(); }
+
+	template<typename T>
+	auto get(T * values, std::size_t n) -> void {
+		static_assert(std::is_trivially_copyable_v<T>, "checkpoint stores raw bytes");
+		std::size_t size{ n * sizeof(T) };
+		if (!ok || bytes.size() - pos < size) {
+			ok = false;
+			return;
+		}
+		std::memcpy(values, bytes.data() + pos, size);
+		pos += size;
+	}
+
+	template<typename T>
+	auto get(T & value) -> void { get(&value, 1); }
+
+	// reads value and checks it against expected one, for config fields that have to match
+	template<typename T>
+	auto expect(const T & expected) -> bool {
+		T value{};
+		get(value);
+		ok = ok && value == expected;
+		return ok;
+	}
+};
+
+class CheckpointWriter {
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable written;
+	std::vector<char> pending;
+	std::string pendingPath;
+	bool hasPending{ false };
+	bool writing{ false };
+	bool stopping{ false };
+	std::thread thread;
+
+	auto writerLoop() -> void {
+		std::vector<char> bytes;
+		std::string path;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			wake.wait(lock, [&] { return hasPending || stopping; });
+			if (!hasPending) return;
+
+			bytes.swap(pending);
+			path.swap(pendingPath);
+			hasPending = false;
+			writing = true;
+
+			lock.unlock();
+			writeFile(path, bytes);
+			lock.lock();
+
+			writing = false;
+			written.notify_all();
+		}
+	}
+
+public:
+	CheckpointWriter() : thread(&CheckpointWriter::writerLoop, this) {}
+
+	CheckpointWriter(const CheckpointWriter &) = delete;
+	CheckpointWriter & operator=(const CheckpointWriter &) = delete;
+
+	~CheckpointWriter() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		thread.join();
+	}
+
+	// takes bytes (swapped with a spare buffer, so caller keeps its capacity), returns at once
+	// unless a snapshot of another path is still pending
+	auto submit(const std::string & path, std::vector<char> & bytes) -> void {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			written.wait(lock, [&] { return !hasPending || pendingPath == path; });
+			pending.swap(bytes);
+			pendingPath = path;
+			hasPending = true;
+		}
+		wake.notify_one();
+	}
+
+	// waits until every submitted snapshot is on disk
+	auto flush() -> void {
+		std::unique_lock<std::mutex> lock(mutex);
+		written.wait(lock, [&] { return !hasPending && !writing; });
+	}
+
+	// writes bytes next to path, then renames over it
+	static auto writeFile(const std::string & path, const std::vector<char> & bytes) -> bool {
+		std::string tmp{ path + ".tmp" };
+		{
+			std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+			file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			file.flush();
+			if (!file) {
+				std::cerr << "Checkpoint Error! cannot write " << tmp << '\n';
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tmp, path, error);
+		if (error) {
+			std::cerr << "Checkpoint Error! cannot rename " << tmp << " to " << path << ": " << error.message() << '\n';
+			return false;
+		}
+		return true;
+	}
+};
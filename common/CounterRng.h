@@ -0,0 +1,92 @@
+/* Counter-based Random Streams
+*
+* Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+* turns a 128-bit counter and 64-bit key into 128 random bits with no
+* state carried between calls. Every stream is addressed by
+* (seed, generation, individual, operator), so the draws one individual
+* gets for selection, crossing or mutation do not depend on what other
+* individuals drew before it, nor on which thread asked first.
+*
+* CounterRng is a UniformRandomBitGenerator over one such stream,
+* usable with every <random> distribution. It is a few dozen bytes,
+* compared to 2.5 KB of std::mt19937.
+*/
+
+#pragma once
+#include <cstdint>
+#include <array>
+#include <limits>
+
+enum class RngOp : std::uint32_t {
+	INIT, SELECTION, CROSSING, MUTATION, EVALUATION,
+};
+
+namespace philox {
+
+using counter_t = std::array<std::uint32_t, 4>;
+using key_t = std::array<std::uint32_t, 2>;
+
+inline auto mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t & hi) -> std::uint32_t {
+	std::uint64_t product{ static_cast<std::uint64_t>(a) * b };
+	hi = static_cast<std::uint32_t>(product >> 32);
+	return static_cast<std::uint32_t>(product);
+}
+
+inline auto block(counter_t ctr, key_t key) -> counter_t {
+	constexpr std::uint32_t M0{ 0xD2511F53u }, M1{ 0xCD9E8D57u };
+	constexpr std::uint32_t W0{ 0x9E3779B9u }, W1{ 0xBB67AE85u };
+
+	for (int round = 0; round < 10; round++) {
+		std::uint32_t hi0, hi1;
+		std::uint32_t lo0{ mulhilo(M0, ctr[0], hi0) };
+		std::uint32_t lo1{ mulhilo(M1, ctr[2], hi1) };
+		ctr = { hi1 ^ ctr[1] ^ key[0], lo1, hi0 ^ ctr[3] ^ key[1], lo0 };
+		key[0] += W0;
+		key[1] += W1;
+	}
+	return ctr;
+}
+
+}
+
+class CounterRng {
+	philox::key_t key;
+	philox::counter_t counter;	// (generation, individual, operator, block index)
+	philox::counter_t buffer;
+	std::uint32_t used;
+
+public:
+	using result_type = std::uint32_t;
+
+	CounterRng(std::uint64_t seed = 0, std::uint32_t generation = 0,
+		std::uint32_t individual = 0, RngOp op = RngOp::INIT) :
+		key{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) },
+		counter{ generation, individual, static_cast<std::uint32_t>(op), 0 },
+		buffer{}, used(4) {}
+
+	static constexpr auto min() -> result_type { return 0; }
+	static constexpr auto max() -> result_type { return std::numeric_limits<result_type>::max(); }
+
+	auto operator()() -> result_type {
+		if (used == 4) {
+			buffer = philox::block(counter, key);
+			counter[3]++;
+			used = 0;
+		}
+		return buffer[used++];
+	}
+};
+
+// factory of streams sharing one seed
+class RngStreams {
+	std::uint64_t seed;
+
+public:
+	explicit RngStreams(std::uint64_t seed = 0) : seed(seed) {}
+
+	auto getSeed() const -> std::uint64_t { return seed; }
+
+	auto operator()(std::uint32_t generation, std::uint32_t individual, RngOp op) const -> CounterRng {
+		return CounterRng{ seed, generation, individual, op };
+	}
+};
@@ -0,0 +1,124 @@
+/* Fitness Cache
+*
+* Remembers fitness of genotypes already evaluated, keyed by genotype
+* value, so repeated individuals are not evaluated again.
+*
+*	DENSE	- direct indexed table of 2^keyBits values with presence bits,
+*			  table memory is left untouched until used, so only pages
+*			  of visited genotypes become resident
+*	HASHED	- bounded direct mapped hash table of hashCapacity slots,
+*			  colliding genotype replaces the one stored before
+*	AUTO	- DENSE when keyBits <= denseMaxBits, HASHED otherwise
+*	NONE	- every lookup evaluates
+*
+* Fitness function has to depend only on key. Not thread safe.
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+enum class CacheMode {
+	NONE, DENSE, HASHED, AUTO,
+};
+
+struct CacheConfig {
+	CacheMode mode{ CacheMode::AUTO };
+	unsigned int denseMaxBits{ 22 };		// 2^22 doubles = 32 MB of address space
+	std::size_t hashCapacity{ 1u << 16 };	// rounded up to power of two
+};
+
+template<typename Fitness = double>
+class FitnessCache {
+	struct Slot {
+		std::uint64_t key{ 0 };
+		Fitness value{ };
+		bool used{ false };
+	};
+
+	CacheMode mode;
+
+	// DENSE
+	std::unique_ptr<Fitness[]> table;
+	std::vector<std::uint64_t> present;
+
+	// HASHED
+	std::vector<Slot> slots;
+	std::uint64_t slotMask{ 0 };
+
+	std::uint64_t hitCount{ 0 };
+	std::uint64_t missCount{ 0 };
+
+	static auto mix(std::uint64_t x) -> std::uint64_t {
+		// splitmix64 finalizer
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+public:
+	// keyBits - number of significant bits of keys
+	FitnessCache(unsigned int keyBits, const CacheConfig & config = CacheConfig{}) : mode(config.mode) {
+		if (mode == CacheMode::AUTO)
+			mode = keyBits <= config.denseMaxBits ? CacheMode::DENSE : CacheMode::HASHED;
+		if (mode == CacheMode::DENSE && keyBits > config.denseMaxBits)
+			mode = CacheMode::HASHED;
+
+		if (mode == CacheMode::DENSE) {
+			std::size_t n{ std::size_t{ 1 } << keyBits };
+			table.reset(new Fitness[n]);
+			present.assign((n + 63) / 64, 0);
+		}
+		else if (mode == CacheMode::HASHED) {
+			std::size_t capacity{ 1 };
+			while (capacity < config.hashCapacity) capacity <<= 1;
+			slots.resize(capacity);
+			slotMask = capacity - 1;
+		}
+	}
+
+	auto getMode() const -> CacheMode { return mode; }
+	auto hits() const -> std::uint64_t { return hitCount; }
+	auto misses() const -> std::uint64_t { return missCount; }
+
+	// returns cached fitness of key, or stores and returns eval()
+	template<typename Eval>
+	auto get(std::uint64_t key, Eval && eval) -> Fitness {
+		switch (mode) {
+		case CacheMode::DENSE: {
+			std::uint64_t & word{ present[key >> 6] };
+			std::uint64_t bit{ std::uint64_t{ 1 } << (key & 63) };
+			if (word & bit) {
+				hitCount++;
+				return table[key];
+			}
+			missCount++;
+			word |= bit;
+			return table[key] = eval();
+		}
+		case CacheMode::HASHED: {
+			Slot & slot{ slots[mix(key) & slotMask] };
+			if (slot.used && slot.key == key) {
+				hitCount++;
+				return slot.value;
+			}
+			missCount++;
+			slot.key = key;
+			slot.used = true;
+			return slot.value = eval();
+		}
+		default:
+			missCount++;
+			return eval();
+		}
+	}
+
+	auto clear() -> void {
+		std::fill(present.begin(), present.end(), 0);
+		for (Slot & slot : slots) slot.used = false;
+		hitCount = missCount = 0;
+	}
+};
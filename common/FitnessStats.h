@@ -0,0 +1,99 @@
+/* Fitness Statistics
+*
+* Population statistics over a contiguous array of fitness values.
+*
+*	summarize	- sum, avg, max and min in one pass
+*	scaleLinear	- linear scaling (Goldberg, multiplier 2 by default) of every
+*				  value, summary of scaled values is taken in the same pass
+*
+* Loops keep lanes independent accumulators, so compiler maps them onto
+* SIMD registers (-O2 with SSE2, wider with -mavx2). Sum is therefore added
+* in different order than plain left to right loop, last bits may differ
+* from it, but result is always the same for the same input.
+*/
+
+#pragma once
+#include <cstddef>
+#include <cmath>
+
+struct FitnessSummary {
+	double sum{ 0.0 };
+	double avg{ 0.0 };
+	double max{ 0.0 };
+	double min{ 0.0 };
+};
+
+namespace stats {
+
+inline constexpr std::size_t lanes{ 4 };
+
+// one pass over value(0) .. value(n-1), empty range gives zero summary
+template<typename Value>
+inline auto reduce(std::size_t n, Value && value) -> FitnessSummary {
+	if (n == 0) return FitnessSummary{};
+
+	double sum[lanes]{ };
+	double max[lanes], min[lanes];
+	double first{ value(0) };
+	for (std::size_t l = 0; l < lanes; l++)
+		max[l] = min[l] = first;
+	sum[0] = first;
+
+	std::size_t i{ 1 };
+	for (; i + lanes <= n; i += lanes) {
+		for (std::size_t l = 0; l < lanes; l++) {
+			double f{ value(i + l) };
+			sum[l] += f;
+			max[l] = f > max[l] ? f : max[l];
+			min[l] = f < min[l] ? f : min[l];
+		}
+	}
+	for (std::size_t l = 0; i < n; i++, l++) {
+		double f{ value(i) };
+		sum[l] += f;
+		max[l] = f > max[l] ? f : max[l];
+		min[l] = f < min[l] ? f : min[l];
+	}
+
+	FitnessSummary summary{ (sum[0] + sum[1]) + (sum[2] + sum[3]), 0.0, max[0], min[0] };
+	for (std::size_t l = 1; l < lanes; l++) {
+		summary.max = max[l] > summary.max ? max[l] : summary.max;
+		summary.min = min[l] < summary.min ? min[l] : summary.min;
+	}
+	summary.avg = summary.sum / n;
+	return summary;
+}
+
+inline auto summarize(const double * fitness, std::size_t n) -> FitnessSummary {
+	return reduce(n, [fitness](std::size_t i) { return fitness[i]; });
+}
+
+// scaled[i] = |a * fitness[i] + b|, where a, b keep average and stretch maximum to multiplier * average
+// (or minimum to zero, when that would make it negative). scaled may be the same array as fitness
+inline auto scaleLinear(const double * fitness, double * scaled, std::size_t n,
+	const FitnessSummary & summary, double multiplier = 2.0) -> FitnessSummary {
+
+	double a{ 1.0 };
+	double b{ 0.0 };
+
+	if (summary.min != summary.max && multiplier != 1.0) {
+		if (summary.min > (multiplier * summary.avg - summary.max) / (multiplier - 1.0)) {
+			double delta{ summary.max - summary.avg };
+			a = (multiplier - 1.0) * summary.avg / delta;
+			b = summary.avg * (summary.max - multiplier * summary.avg) / delta;
+		}
+		else {
+			double delta{ summary.avg - summary.min };
+			a = summary.avg / delta;
+			b = -summary.min * summary.avg / delta;
+		}
+	}
+
+	return reduce(n, [=](std::size_t i) {
+		double f{ std::fabs(a * fitness[i] + b) };
+		scaled[i] = f;
+		return f;
+	});
+}
+
+}
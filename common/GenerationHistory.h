@@ -0,0 +1,93 @@
+/* Generation History
+*
+* Decides what happens to populations of past generations, engines
+* themselves only keep two buffers (last and current) swapped by index.
+*
+*	NONE	- nothing is kept
+*	RING	- copies of last ringSize generations, slots are reused
+*	STREAM	- every generation is appended to binary file at streamPath,
+*			  as (int generation, Population::write output) records
+*
+* Memory stays flat in every mode, no matter how many generations run.
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+enum class HistoryPolicy {
+	NONE, RING, STREAM,
+};
+
+struct HistoryConfig {
+	HistoryPolicy policy{ HistoryPolicy::NONE };
+	std::size_t ringSize{ 8 };
+	std::string streamPath{ "generations.bin" };
+};
+
+template<typename Population>
+class GenerationHistory {
+	HistoryConfig config;
+
+	std::vector<Population> ring;
+	std::vector<int> ringGenerations;
+	std::size_t ringNext{ 0 };
+	std::size_t ringCount{ 0 };
+
+	std::ofstream stream;
+
+public:
+	explicit GenerationHistory(const HistoryConfig & config) : config(config) {
+		if (config.policy == HistoryPolicy::RING && config.ringSize == 0)
+			this->config.policy = HistoryPolicy::NONE;
+
+		if (this->config.policy == HistoryPolicy::STREAM) {
+			stream.open(config.streamPath, std::ios::binary | std::ios::trunc);
+			if (!stream) std::cerr << "History Error! Cannot open " << config.streamPath << '\n';
+		}
+	}
+
+	auto policy() const -> HistoryPolicy { return config.policy; }
+
+	auto record(int generation, const Population & pop) -> void {
+		switch (config.policy) {
+		case HistoryPolicy::NONE: break;
+		case HistoryPolicy::RING:
+			if (ring.size() < config.ringSize) {
+				ring.push_back(pop);
+				ringGenerations.push_back(generation);
+			}
+			else {
+				ring[ringNext] = pop;
+				ringGenerations[ringNext] = generation;
+			}
+			ringNext = (ringNext + 1) % config.ringSize;
+			ringCount = std::min(ringCount + 1, config.ringSize);
+			break;
+		case HistoryPolicy::STREAM:
+			stream.write(reinterpret_cast<const char *>(&generation), sizeof(generation));
+			pop.write(stream);
+			break;
+		}
+	}
+
+	// number of generations kept in memory
+	auto size() const -> std::size_t { return ringCount; }
+
+	// ago = 0 is the most recently recorded generation
+	auto recent(std::size_t ago) const -> const Population& {
+		return ring[(ringNext + config.ringSize - 1 - ago) % config.ringSize];
+	}
+
+	auto recentGeneration(std::size_t ago) const -> int {
+		return ringGenerations[(ringNext + config.ringSize - 1 - ago) % config.ringSize];
+	}
+
+	auto flush() -> void {
+		if (stream.is_open()) stream.flush();
+	}
+};
@@ -0,0 +1,53 @@
+/* Geometric Skip Mutation
+*
+* Flips every bit of a flattened bitstream (whole population, individual
+* after individual) independently with probability p. Instead of one
+* Bernoulli draw per allele, the gap to the next flipped bit is drawn from
+* geometric distribution P(gap = k) = (1 - p)^k * p, which gives exactly
+* the same per-bit probability, but costs one draw per mutation.
+*/
+
+#pragma once
+#include <cstdint>
+#include <random>
+
+class GeometricMutation {
+	double pMut;
+	std::geometric_distribution<std::uint64_t> skipDis;
+
+public:
+	explicit GeometricMutation(double p) : pMut(p),
+		skipDis(p > 0.0 && p < 1.0 ? p : 0.5) {}
+
+	auto probability() const -> double { return pMut; }
+
+	// calls flip(pos) for every mutated position in [0, nBits)
+	// positions come in increasing order, returns number of mutations
+	template<typename Gen, typename Flip>
+	auto apply(std::uint64_t nBits, Gen & gen, Flip && flip) -> std::uint64_t {
+		if (pMut <= 0.0 || nBits == 0) return 0;
+
+		if (pMut >= 1.0) {
+			for (std::uint64_t pos = 0; pos < nBits; pos++)
+				flip(pos);
+			return nBits;
+		}
+
+		std::uint64_t mutations{ 0 };
+		std::uint64_t pos{ 0 };
+
+		// invariant: pos < nBits
+		for (;;) {
+			std::uint64_t gap{ skipDis(gen) };
+			if (gap >= nBits - pos) break;
+
+			pos += gap;
+			flip(pos);
+			mutations++;
+
+			if (++pos == nBits) break;
+		}
+
+		return mutations;
+	}
+};
@@ -0,0 +1,96 @@
+/* Oracle
+*
+* Ground truth for benchmarks: the best fitness a problem can reach.
+*
+*	exhaustive	- evaluates every genotype of a bits-long search space
+*				  (2^10 of SGA, 2^22 of sine GA) in parallel chunks
+*	sampled		- scores given number of candidates drawn by caller,
+*				  for spaces too large to enumerate (GAP strategies);
+*				  result is a lower bound of the optimum
+*
+* Every chunk keeps its own best, chunks are reduced in index order and
+* ties go to the lowest genotype, so result does not depend on thread count.
+*/
+
+#pragma once
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+struct OracleResult {
+	double best{ -std::numeric_limits<double>::infinity() };
+	std::uint64_t argBest{ 0 };		// first genotype (or sample) reaching best
+	std::uint64_t optima{ 0 };		// genotypes with exactly best fitness
+	std::uint64_t evaluated{ 0 };
+};
+
+namespace oracle {
+
+// counts value at genotype in running result, earlier genotype keeps ties
+inline auto offer(OracleResult & r, double value, std::uint64_t genotype) -> void {
+	if (value > r.best) {
+		r.best = value;
+		r.argBest = genotype;
+		r.optima = 1;
+	}
+	else if (value == r.best) r.optima++;
+	r.evaluated++;
+}
+
+// merges per-chunk results in chunk order
+inline auto reduce(const std::vector<OracleResult> & partial) -> OracleResult {
+	OracleResult result;
+	for (const OracleResult & r : partial) {
+		if (r.best > result.best) {
+			result.best = r.best;
+			result.argBest = r.argBest;
+			result.optima = r.optima;
+		}
+		else if (r.best == result.best) result.optima += r.optima;
+		result.evaluated += r.evaluated;
+	}
+	return result;
+}
+
+// evaluate(first, fitness) fills fitness[i] of genotype first + i, called from pool threads
+template<typename Evaluate>
+auto exhaustive(unsigned int bits, ThreadPool & pool, Evaluate && evaluate, std::size_t chunk = 4096) -> OracleResult {
+	std::uint64_t space{ std::uint64_t{ 1 } << bits };
+	std::size_t nChunks{ static_cast<std::size_t>((space + chunk - 1) / chunk) };
+	std::vector<OracleResult> partial(nChunks);
+	std::vector<std::vector<double>> fitness(pool.size(), std::vector<double>(chunk));
+
+	pool.parallelFor(nChunks, Schedule::WORK_STEALING, 1, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+		std::vector<double> & buf{ fitness[worker] };
+		for (std::size_t c = begin; c < end; c++) {
+			std::uint64_t first{ static_cast<std::uint64_t>(c) * chunk };
+			std::size_t n{ static_cast<std::size_t>(std::min<std::uint64_t>(chunk, space - first)) };
+			evaluate(first, std::span<double>(buf.data(), n));
+			for (std::size_t i = 0; i < n; i++) offer(partial[c], buf[i], first + i);
+		}
+	});
+	return reduce(partial);
+}
+
+// score(sample) -> double of sample-th candidate, called from pool threads,
+// candidate has to depend on sample index alone (e.g. drawn from counter RNG)
+template<typename Score>
+auto sampled(std::uint64_t samples, ThreadPool & pool, Score && score, std::size_t chunk = 256) -> OracleResult {
+	std::size_t nChunks{ static_cast<std::size_t>((samples + chunk - 1) / chunk) };
+	std::vector<OracleResult> partial(nChunks);
+
+	pool.parallelFor(nChunks, Schedule::WORK_STEALING, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t c = begin; c < end; c++) {
+			std::uint64_t first{ static_cast<std::uint64_t>(c) * chunk };
+			std::uint64_t last{ std::min<std::uint64_t>(first + chunk, samples) };
+			for (std::uint64_t sample = first; sample < last; sample++) offer(partial[c], score(sample), sample);
+		}
+	});
+	return reduce(partial);
+}
+
+}
@@ -0,0 +1,81 @@
+#include "PackedGenome.h"
+#include <cmath>
+#include <algorithm>
+
+PackedGenome::PackedGenome() : length(0), words() {}
+
+PackedGenome::PackedGenome(std::size_t length) :
+	length(length), words((length + wordBits - 1) / wordBits, 0) {}
+
+auto PackedGenome::test(std::size_t allele) const -> bool {
+	std::size_t pos{ length - 1 - allele };
+	return (words[pos / wordBits] >> (pos % wordBits)) & 1u;
+}
+
+auto PackedGenome::set(std::size_t allele, bool value) -> void {
+	std::size_t pos{ length - 1 - allele };
+	word_t bit{ word_t{ 1 } << (pos % wordBits) };
+	if (value) words[pos / wordBits] |= bit;
+	else words[pos / wordBits] &= ~bit;
+}
+
+auto PackedGenome::flip(std::size_t allele) -> void {
+	std::size_t pos{ length - 1 - allele };
+	words[pos / wordBits] ^= word_t{ 1 } << (pos % wordBits);
+}
+
+auto PackedGenome::clearTail() -> void {
+	std::size_t tail{ length % wordBits };
+	if (tail && !words.empty())
+		words.back() &= (word_t{ 1 } << tail) - 1;
+}
+
+auto PackedGenome::rangeMask(std::size_t w, std::size_t lo, std::size_t hi) -> word_t {
+	std::size_t first{ w * wordBits };
+	std::size_t l{ std::max(lo, first) };
+	std::size_t h{ std::min(hi, first + wordBits) };
+	if (l >= h) return 0;
+
+	word_t below{ h - first == wordBits ? ~word_t{ 0 } : (word_t{ 1 } << (h - first)) - 1 };
+	return below & (~word_t{ 0 } << (l - first));
+}
+
+auto PackedGenome::swapRangeInto(const PackedGenome & a, const PackedGenome & b,
+	PackedGenome & childA, PackedGenome & childB, std::size_t first, std::size_t last) -> void {
+	// alleles [first, last) are bit positions [length - last, length - first)
+	std::size_t lo{ a.length - last };
+	std::size_t hi{ a.length - first };
+	for (std::size_t w = 0; w < a.words.size(); w++)
+		crossWord(a, b, childA, childB, w, rangeMask(w, lo, hi));
+}
+
+auto PackedGenome::multiPointCrossInto(const PackedGenome & a, const PackedGenome & b,
+	PackedGenome & childA, PackedGenome & childB, const std::vector<std::size_t> & points) -> void {
+	for (std::size_t w = 0; w < a.words.size(); w++) {
+		// segments [0, p1), [p2, p3), ...
+		word_t mask{ 0 };
+		std::size_t begin{ 0 };
+		bool swapping{ true };
+		for (std::size_t point : points) {
+			if (swapping) mask |= rangeMask(w, a.length - point, a.length - begin);
+			begin = point;
+			swapping = !swapping;
+		}
+		if (swapping) mask |= rangeMask(w, 0, a.length - begin);
+
+		crossWord(a, b, childA, childB, w, mask);
+	}
+}
+
+auto PackedGenome::decode() const -> double {
+	double x{ 0.0 };
+	for (std::size_t w = words.size(); w-- > 0; )
+		x += std::ldexp(static_cast<double>(words[w]), static_cast<int>(w * wordBits));
+	return x;
+}
+
+auto operator<<(std::ostream & stream, const PackedGenome & genome) -> std::ostream& {
+	for (std::size_t i = 0; i < genome.size(); i++)
+		stream << genome.test(i);
+	return stream;
+}
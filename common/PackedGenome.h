@@ -0,0 +1,118 @@
+/* Packed Genome
+*
+* Binary chromosome of runtime length stored in 64-bit words.
+* Allele 0 is the most significant bit of the encoded value, so
+* allele i lives at bit position (length - 1 - i) of the word array
+* and decoding is a plain little-endian sum of words.
+*
+* Crossing operators write children whole words at a time, taking
+* bits under masks from the other parent, instead of copying alleles
+* one at a time.
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <iostream>
+#include <random>
+
+class PackedGenome {
+public:
+	using word_t = std::uint64_t;
+	static constexpr std::size_t wordBits{ 64 };
+
+	PackedGenome();
+	explicit PackedGenome(std::size_t length);
+
+	auto size() const -> std::size_t { return length; }
+	auto wordCount() const -> std::size_t { return words.size(); }
+	auto data() -> word_t* { return words.data(); }
+	auto data() const -> const word_t* { return words.data(); }
+
+	auto test(std::size_t allele) const -> bool;
+	auto set(std::size_t allele, bool value = true) -> void;
+	auto flip(std::size_t allele) -> void;
+
+	// fills every allele with a fair coin, one draw per word
+	template<typename Gen>
+	auto randomize(Gen & gen) -> void {
+		std::uniform_int_distribution<word_t> wordDis;
+		for (word_t & w : words)
+			w = wordDis(gen);
+		clearTail();
+	}
+
+	// crossing operators: children are written once, word by word, from parents a and b,
+	// swapped alleles come from the other parent.
+	// children have length of parents and may not be the parents themselves
+
+	// swaps alleles [first, last)
+	static auto swapRangeInto(const PackedGenome & a, const PackedGenome & b,
+		PackedGenome & childA, PackedGenome & childB, std::size_t first, std::size_t last) -> void;
+
+	// swaps [0, p1), [p2, p3), ..., points have to be sorted
+	static auto multiPointCrossInto(const PackedGenome & a, const PackedGenome & b,
+		PackedGenome & childA, PackedGenome & childB, const std::vector<std::size_t> & points) -> void;
+
+	// swaps every allele with probability 0.5, one draw per word
+	template<typename Gen>
+	static auto uniformCrossInto(const PackedGenome & a, const PackedGenome & b,
+		PackedGenome & childA, PackedGenome & childB, Gen & gen) -> void {
+		std::uniform_int_distribution<word_t> wordDis;
+		for (std::size_t w = 0; w < a.words.size(); w++)
+			crossWord(a, b, childA, childB, w, wordDis(gen));
+	}
+
+	// value of the genome as unsigned binary number (allele 0 is MSB)
+	// exact up to 53 bits, finite up to 1023 bits, may overflow to inf from 1024 bits on
+	auto decode() const -> double;
+
+	// exact value of genomes up to 64 bits (lowest word otherwise)
+	auto toUInt64() const -> word_t { return words.empty() ? 0 : words.front(); }
+
+	// inverse of toUInt64 for genomes up to 64 bits, bits above length are dropped
+	auto fromUInt64(word_t value) -> void {
+		if (words.empty()) return;
+		words.front() = value;
+		clearTail();
+	}
+
+	// value of alleles [first, first + count) as unsigned number (allele first is MSB), count <= 64
+	auto field(std::size_t first, std::size_t count) const -> word_t {
+		std::size_t lo{ length - first - count };
+		std::size_t w{ lo / wordBits };
+		std::size_t shift{ lo % wordBits };
+		word_t value{ words[w] >> shift };
+		if (shift + count > wordBits) value |= words[w + 1] << (wordBits - shift);
+		return count == wordBits ? value : value & ((word_t{ 1 } << count) - 1);
+	}
+
+	// raw words, length is known by the reader
+	auto write(std::ostream & file) const -> void {
+		file.write(reinterpret_cast<const char *>(words.data()), words.size() * sizeof(word_t));
+	}
+
+	friend auto operator==(const PackedGenome & a, const PackedGenome & b) -> bool {
+		return a.length == b.length && a.words == b.words;
+	}
+	friend auto operator<<(std::ostream & stream, const PackedGenome & genome) -> std::ostream&;
+
+private:
+	std::size_t length;
+	std::vector<word_t> words;
+
+	// masks bits above length in the last word
+	auto clearTail() -> void;
+
+	// bits of word w that lie in positions [lo, hi)
+	static auto rangeMask(std::size_t w, std::size_t lo, std::size_t hi) -> word_t;
+
+	// writes word w of children, bits selected by mask are taken from the other parent
+	static inline auto crossWord(const PackedGenome & a, const PackedGenome & b,
+		PackedGenome & childA, PackedGenome & childB, std::size_t w, word_t mask) -> void {
+		word_t diff{ (a.words[w] ^ b.words[w]) & mask };
+		childA.words[w] = a.words[w] ^ diff;
+		childB.words[w] = b.words[w] ^ diff;
+	}
+};
@@ -0,0 +1,92 @@
+/* Population Buffer
+*
+* Storage of individuals, either fixed at compile time (std::array member,
+* used by fast paths of default problem sizes) or sized at runtime
+* (heap allocated vector, aligned to cache line).
+* Both specializations share the same interface, so engines can be
+* templated on Extent without caring which one they got.
+*/
+
+#pragma once
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <limits>
+#include <new>
+
+inline constexpr std::size_t dynamicSize{ std::numeric_limits<std::size_t>::max() };
+inline constexpr std::size_t cacheLineSize{ 64 };
+
+template<typename T>
+struct CacheAlignedAllocator {
+	using value_type = T;
+
+	CacheAlignedAllocator() = default;
+	template<typename U>
+	CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+
+	auto allocate(std::size_t n) -> T* {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ cacheLineSize }));
+	}
+
+	auto deallocate(T * p, std::size_t) -> void {
+		::operator delete(p, std::align_val_t{ cacheLineSize });
+	}
+
+	template<typename U>
+	friend auto operator==(const CacheAlignedAllocator &, const CacheAlignedAllocator<U> &) -> bool { return true; }
+	template<typename U>
+	friend auto operator!=(const CacheAlignedAllocator &, const CacheAlignedAllocator<U> &) -> bool { return false; }
+};
+
+template<typename T>
+using aligned_vector = std::vector<T, CacheAlignedAllocator<T>>;
+
+template<typename T, std::size_t Extent = dynamicSize>
+class PopulationBuffer {
+	alignas(cacheLineSize) std::array<T, Extent> items;
+
+public:
+	// size argument is there only to match dynamic buffer interface
+	explicit PopulationBuffer(std::size_t = Extent) : items() {}
+
+	static constexpr auto size() -> std::size_t { return Extent; }
+
+	auto data() -> T* { return items.data(); }
+	auto data() const -> const T* { return items.data(); }
+
+	auto operator[](std::size_t i) -> T& { return items[i]; }
+	auto operator[](std::size_t i) const -> const T& { return items[i]; }
+
+	auto front() -> T& { return items.front(); }
+	auto front() const -> const T& { return items.front(); }
+
+	auto begin() { return items.begin(); }
+	auto end() { return items.end(); }
+	auto begin() const { return items.begin(); }
+	auto end() const { return items.end(); }
+};
+
+template<typename T>
+class PopulationBuffer<T, dynamicSize> {
+	aligned_vector<T> items;
+
+public:
+	explicit PopulationBuffer(std::size_t n = 0) : items(n) {}
+
+	auto size() const -> std::size_t { return items.size(); }
+
+	auto data() -> T* { return items.data(); }
+	auto data() const -> const T* { return items.data(); }
+
+	auto operator[](std::size_t i) -> T& { return items[i]; }
+	auto operator[](std::size_t i) const -> const T& { return items[i]; }
+
+	auto front() -> T& { return items.front(); }
+	auto front() const -> const T& { return items.front(); }
+
+	auto begin() { return items.begin(); }
+	auto end() { return items.end(); }
+	auto begin() const { return items.begin(); }
+	auto end() const { return items.end(); }
+};
@@ -0,0 +1,308 @@
+/* Run Trace
+*
+* Per-generation statistics, and optionally every genome with its fitness,
+* appended to a columnar binary file. Engine fills rows of an in-memory
+* block; a full block is handed to TraceWriter thread, which writes it
+* while the engine fills the spare one. The only cost on the generation
+* loop is a copy of stats and genome words.
+*
+* File: TraceHeader, then blocks of up to blockRows generations:
+*
+*	std::uint64_t rows
+*	std::int32_t generation[rows]
+*	std::uint64_t evaluations[rows]
+*	double max[rows], avg[rows], min[rows]
+*	double fitness[rows * popSize]						genomes only
+*	std::uint64_t words[rows * popSize * genomeWords]	genomes only
+*
+* Each column of a block is contiguous and padded to 8 bytes, so a reader
+* can scan one column of mapped file in place without touching the others.
+* Genome words are copied as the engine stores them, header tells where
+* locus i is (traceLocus reads it). Native endianness. The file is opened with truncation, so a resumed run
+* traces only generations it evolves itself.
+*/
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TraceConfig {
+	std::string path;				// empty disables trace
+	bool genomes{ false };			// also store every genome and its fitness
+	std::size_t blockRows{ 64 };	// generations per block
+};
+
+enum class TraceEngine : std::uint32_t {
+	SGA = 1, GA = 2, GAP = 3,
+};
+
+// bit of genome words holding locus i
+enum class TraceGenomeOrder : std::uint32_t {
+	LOW_FIRST = 0,		// bit i (GAP strategy)
+	HIGH_FIRST = 1,		// bit genomeBits - 1 - i (PackedGenome, allele 0 is the most significant)
+};
+
+struct TraceHeader {
+	static constexpr char expectedMagic[8]{ 'G', 'P', 'T', 'R', 'A', 'C', 'E', '\0' };
+	static constexpr std::uint32_t currentVersion{ 2 };
+
+	char magic[8]{};
+	std::uint32_t version{ 0 };
+	TraceEngine engine{};
+	std::uint64_t popSize{ 0 };
+	std::uint64_t genomeWords{ 0 };	// 0 when genomes are not stored
+	std::uint64_t genomeBits{ 0 };	// loci per genome
+	TraceGenomeOrder genomeOrder{};
+	std::uint32_t reserved{ 0 };
+};
+
+// locus of genome stored in trace, words point to its genomeWords words
+inline auto traceLocus(const TraceHeader & header, const std::uint64_t * words, std::size_t locus) -> bool {
+	std::size_t bit{ header.genomeOrder == TraceGenomeOrder::HIGH_FIRST
+		? static_cast<std::size_t>(header.genomeBits) - 1 - locus : locus };
+	return (words[bit / 64] >> (bit % 64)) & 1u;
+}
+
+// generation stats, one row of trace
+struct TraceRow {
+	std::int32_t generation{ 0 };
+	std::uint64_t evaluations{ 0 };
+	double max{ 0.0 };
+	double avg{ 0.0 };
+	double min{ 0.0 };
+};
+
+class TraceWriter {
+	struct Block {
+		std::size_t rows{ 0 };
+		std::vector<std::int32_t> generation;
+		std::vector<std::uint64_t> evaluations;
+		std::vector<double> max, avg, min;
+		std::vector<double> fitness;
+		std::vector<std::uint64_t> words;
+
+		Block(std::size_t capacity, std::size_t popSize, std::size_t genomeWords) :
+			generation(capacity), evaluations(capacity), max(capacity), avg(capacity), min(capacity),
+			fitness(genomeWords ? capacity * popSize : 0), words(capacity * popSize * genomeWords) {}
+	};
+
+	const std::size_t capacity;
+	const std::size_t popSize;
+	const std::size_t genomeWords;
+
+	std::ofstream file;
+	Block filling;		// rows added by engine
+	Block pending;		// full block waiting for writer, swapped with filling
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable written;
+	bool hasPending{ false };
+	bool stopping{ false };
+	std::thread thread;
+
+	auto writerLoop() -> void {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			wake.wait(lock, [&] { return hasPending || stopping; });
+			if (!hasPending) return;
+
+			// engine does not touch pending until hasPending is cleared
+			lock.unlock();
+			writeBlock(pending);
+			lock.lock();
+
+			hasPending = false;
+			written.notify_all();
+		}
+	}
+
+	template<typename T>
+	auto writeColumn(const std::vector<T> & column, std::size_t n) -> void {
+		static constexpr char padding[8]{};
+		std::size_t size{ n * sizeof(T) };
+		file.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(size));
+		file.write(padding, static_cast<std::streamsize>(paddedSize(size) - size));
+	}
+
+	auto writeBlock(const Block & block) -> void {
+		std::uint64_t rows{ block.rows };
+		file.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+		writeColumn(block.generation, block.rows);
+		writeColumn(block.evaluations, block.rows);
+		writeColumn(block.max, block.rows);
+		writeColumn(block.avg, block.rows);
+		writeColumn(block.min, block.rows);
+		if (genomeWords) {
+			writeColumn(block.fitness, block.rows * popSize);
+			writeColumn(block.words, block.rows * popSize * genomeWords);
+		}
+	}
+
+	// waits for writer to take previous block, then gives it the filling one
+	auto submit() -> void {
+		if (filling.rows == 0) return;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			written.wait(lock, [&] { return !hasPending; });
+			std::swap(filling, pending);
+			hasPending = true;
+		}
+		wake.notify_one();
+		filling.rows = 0;
+	}
+
+public:
+	static constexpr auto paddedSize(std::size_t size) -> std::size_t { return (size + 7) / 8 * 8; }
+
+	// genomeBits = 0 stores stats only, no matter what config says, order tells how engine lays out genome words
+	TraceWriter(const TraceConfig & config, TraceEngine engine, std::size_t popSize, std::size_t genomeBits,
+		TraceGenomeOrder order) :
+		capacity(config.blockRows ? config.blockRows : 1), popSize(popSize),
+		genomeWords(config.genomes ? (genomeBits + 63) / 64 : 0),
+		file(config.path, std::ios::binary | std::ios::trunc),
+		filling(capacity, popSize, genomeWords), pending(capacity, popSize, genomeWords) {
+		if (!file) std::cerr << "Trace Error! cannot open " << config.path << '\n';
+
+		TraceHeader header;
+		std::memcpy(header.magic, TraceHeader::expectedMagic, sizeof(header.magic));
+		header.version = TraceHeader::currentVersion;
+		header.engine = engine;
+		header.popSize = popSize;
+		header.genomeWords = genomeWords;
+		header.genomeBits = genomeBits;
+		header.genomeOrder = order;
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+		thread = std::thread(&TraceWriter::writerLoop, this);
+	}
+
+	TraceWriter(const TraceWriter &) = delete;
+	TraceWriter & operator=(const TraceWriter &) = delete;
+
+	~TraceWriter() {
+		flush();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		thread.join();
+	}
+
+	auto tracesGenomes() const -> bool { return genomeWords != 0; }
+	auto wordsPerGenome() const -> std::size_t { return genomeWords; }
+
+	// starts row of next generation, genomes of it are filled through fitness() and genome()
+	auto add(const TraceRow & row) -> void {
+		if (filling.rows == capacity) submit();
+		std::size_t r{ filling.rows++ };
+		filling.generation[r] = row.generation;
+		filling.evaluations[r] = row.evaluations;
+		filling.max[r] = row.max;
+		filling.avg[r] = row.avg;
+		filling.min[r] = row.min;
+	}
+
+	// slots of individual i in the row added last, only when tracesGenomes()
+	auto fitness(std::size_t i) -> double& { return filling.fitness[(filling.rows - 1) * popSize + i]; }
+	auto genome(std::size_t i) -> std::span<std::uint64_t> {
+		return { filling.words.data() + ((filling.rows - 1) * popSize + i) * genomeWords, genomeWords };
+	}
+
+	// writes every added row, waits until it is in file
+	auto flush() -> void {
+		submit();
+		std::unique_lock<std::mutex> lock(mutex);
+		written.wait(lock, [&] { return !hasPending; });
+		file.flush();
+	}
+};
+
+// trace file read from memory (mapped or loaded), blocks are indexed on construction
+class TraceView {
+	struct BlockRef {
+		std::size_t rows{ 0 };
+		std::size_t firstRow{ 0 };
+		const std::int32_t * generation{ nullptr };
+		const std::uint64_t * evaluations{ nullptr };
+		const double * max{ nullptr };
+		const double * avg{ nullptr };
+		const double * min{ nullptr };
+		const double * fitness{ nullptr };
+		const std::uint64_t * words{ nullptr };
+	};
+
+	TraceHeader head;
+	std::vector<BlockRef> blocks;
+	std::size_t nRows{ 0 };
+	bool ok{ false };
+	bool whole{ false };
+
+	template<typename T>
+	static auto column(const char *& at, const char * end, std::size_t n, const T *& out) -> bool {
+		std::size_t size{ TraceWriter::paddedSize(n * sizeof(T)) };
+		if (static_cast<std::size_t>(end - at) < size) return false;
+		out = reinterpret_cast<const T *>(at);
+		at += size;
+		return true;
+	}
+
+public:
+	// data has to stay alive and 8 byte aligned (mmap and vector<uint64_t> are)
+	TraceView(const char * data, std::size_t size) {
+		if (size < sizeof(TraceHeader)) return;
+		std::memcpy(&head, data, sizeof(head));
+		if (std::memcmp(head.magic, TraceHeader::expectedMagic, sizeof(head.magic)) != 0
+			|| head.version != TraceHeader::currentVersion) return;
+
+		const char * at{ data + sizeof(TraceHeader) };
+		const char * end{ data + size };
+		std::size_t pop{ static_cast<std::size_t>(head.popSize) };
+		std::size_t words{ static_cast<std::size_t>(head.genomeWords) };
+
+		ok = true;
+		whole = true;
+		while (at < end && whole) {
+			const std::uint64_t * rows{ nullptr };
+			BlockRef block;
+			whole = column(at, end, 1, rows);
+			if (whole) {
+				block.rows = static_cast<std::size_t>(*rows);
+				block.firstRow = nRows;
+				whole = column(at, end, block.rows, block.generation) && column(at, end, block.rows, block.evaluations)
+					&& column(at, end, block.rows, block.max) && column(at, end, block.rows, block.avg)
+					&& column(at, end, block.rows, block.min);
+			}
+			if (whole && words)
+				whole = column(at, end, block.rows * pop, block.fitness) && column(at, end, block.rows * pop * words, block.words);
+			if (!whole) break;
+
+			blocks.push_back(block);
+			nRows += block.rows;
+		}
+	}
+
+	// false on foreign file
+	auto good() const -> bool { return ok; }
+	// false when file ends inside a block (killed run), every whole block before the cut is still read
+	auto complete() const -> bool { return whole; }
+	auto header() const -> const TraceHeader& { return head; }
+	auto rows() const -> std::size_t { return nRows; }
+	auto hasGenomes() const -> bool { return head.genomeWords != 0; }
+
+	// calls visit(block) for every block, columns are raw pointers into the file
+	template<typename Visit>
+	auto forEachBlock(Visit && visit) const -> void {
+		for (const BlockRef & block : blocks) visit(block);
+	}
+};
@@ -0,0 +1,111 @@
+/* Seed Sweep
+*
+* Runs one evolution per seed of range [firstSeed, firstSeed + seeds) on
+* a thread pool. Every worker builds its engine once and reseeds it for
+* the next run, so population buffers are allocated once per thread.
+* Seeds are balanced by work stealing, but every result lands in the slot
+* of its seed, so output does not depend on thread count.
+*
+* Results are written as CSV, or as packed SweepRecord array when file
+* name ends with ".bin".
+*/
+
+#pragma once
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SweepConfig {
+	unsigned int firstSeed{ 1u };
+	std::size_t seeds{ 1000 };
+	std::size_t threads{ 0 };		// 0 is hardware concurrency
+	std::string output;				// empty writes no file
+};
+
+struct SweepRecord {
+	std::uint64_t seed{ 0 };
+	double best{ 0.0 };				// best population max over all generations
+	std::int32_t bestGeneration{ 0 };	// first generation that reached best
+	std::int32_t generations{ 0 };	// generations evolved
+	std::uint64_t evaluations{ 0 };
+};
+
+namespace sweep {
+
+// make(worker) -> std::unique_ptr<Engine>, run(engine, seed) -> SweepRecord
+template<typename Make, typename Run>
+auto run(const SweepConfig & config, Make && make, Run && runSeed) -> std::vector<SweepRecord> {
+	std::vector<SweepRecord> records(config.seeds);
+	ThreadPool pool(config.threads);
+
+	using Engine = typename decltype(make(std::size_t{ 0 }))::element_type;
+	std::vector<std::unique_ptr<Engine>> engines(pool.size());
+
+	pool.parallelFor(config.seeds, Schedule::WORK_STEALING, 1, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+		std::unique_ptr<Engine> & engine{ engines[worker] };
+		if (!engine) engine = make(worker);
+		for (std::size_t i = begin; i < end; i++)
+			records[i] = runSeed(*engine, config.firstSeed + static_cast<unsigned int>(i));
+	});
+	return records;
+}
+
+inline auto write(const std::string & path, const std::vector<SweepRecord> & records) -> bool {
+	bool binary{ path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0 };
+	std::ofstream file(path, binary ? std::ios::binary : std::ios::out);
+	if (!file) {
+		std::cerr << "Sweep Error! cannot open " << path << '\n';
+		return false;
+	}
+
+	if (binary) {
+		file.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(SweepRecord));
+		return static_cast<bool>(file);
+	}
+
+	file << "seed,best,bestGeneration,generations,evaluations\n" << std::setprecision(17);
+	for (const SweepRecord & r : records)
+		file << r.seed << ',' << r.best << ',' << r.bestGeneration << ',' << r.generations << ',' << r.evaluations << '\n';
+	return static_cast<bool>(file);
+}
+
+// q-th quantile of sorted values, linear interpolation between closest ranks
+inline auto quantile(const std::vector<double> & sorted, double q) -> double {
+	if (sorted.empty()) return 0.0;
+	double pos{ q * static_cast<double>(sorted.size() - 1) };
+	std::size_t lo{ static_cast<std::size_t>(pos) };
+	std::size_t hi{ std::min(lo + 1, sorted.size() - 1) };
+	return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - static_cast<double>(lo));
+}
+
+// min, 10%, 25%, median, 75%, 90%, max of best fitness, best generation and evaluations
+inline auto printQuantiles(std::ostream & stream, const std::vector<SweepRecord> & records) -> void {
+	const double qs[]{ 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 };
+
+	auto row = [&](const std::string & name, auto field) {
+		std::vector<double> values(records.size());
+		std::transform(records.begin(), records.end(), values.begin(), field);
+		std::sort(values.begin(), values.end());
+		stream << std::left << std::setw(16) << name << std::right;
+		for (double q : qs) stream << std::setw(14) << quantile(values, q);
+		stream << '\n';
+	};
+
+	stream << "Sweep of " << records.size() << " seeds\n" << std::setw(16) << "";
+	for (const char * name : { "min", "10%", "25%", "median", "75%", "90%", "max" })
+		stream << std::setw(14) << name;
+	stream << '\n';
+
+	row("best", [](const SweepRecord & r) { return r.best; });
+	row("bestGeneration", [](const SweepRecord & r) { return static_cast<double>(r.bestGeneration); });
+	row("evaluations", [](const SweepRecord & r) { return static_cast<double>(r.evaluations); });
+}
+
+}
@@ -0,0 +1,148 @@
+/* Selection
+*
+* Fitness proportionate sampling schemes, that emit indices of selected
+* parents instead of copying individuals. Every scheme costs O(n) or
+* O(n log n) per generation:
+*
+*	AliasTable			- Walker/Vose alias method, O(n) build, O(1) per draw
+*	stochasticUniversal	- one spin with n evenly spaced pointers, O(n)
+*	remainderStochastic	- integer parts of expected copies are copied for sure,
+*						  fractions compete in one bounded Bernoulli pass,
+*						  slots left are filled by SUS over fractions, O(n log n)
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+class AliasTable {
+	std::vector<double> prob;
+	std::vector<std::size_t> alias;
+
+	// work stacks, kept between builds
+	std::vector<std::size_t> small;
+	std::vector<std::size_t> large;
+
+public:
+	AliasTable() = default;
+
+	// builds table for given non-negative weights, all zero weights give uniform sampling
+	auto build(const double * weights, std::size_t n) -> void {
+		prob.resize(n);
+		alias.resize(n);
+		small.clear();
+		large.clear();
+
+		double sum{ std::accumulate(weights, weights + n, 0.0) };
+
+		for (std::size_t i = 0; i < n; i++) {
+			prob[i] = sum > 0.0 ? weights[i] * n / sum : 1.0;
+			alias[i] = i;
+			if (prob[i] < 1.0) small.push_back(i);
+			else large.push_back(i);
+		}
+
+		while (!small.empty() && !large.empty()) {
+			std::size_t s{ small.back() };
+			std::size_t l{ large.back() };
+			small.pop_back();
+
+			alias[s] = l;
+			prob[l] -= 1.0 - prob[s];
+
+			if (prob[l] < 1.0) {
+				large.pop_back();
+				small.push_back(l);
+			}
+		}
+
+		// leftovers differ from 1.0 only by rounding error
+		for (std::size_t i : small) prob[i] = 1.0;
+		for (std::size_t i : large) prob[i] = 1.0;
+	}
+
+	auto size() const -> std::size_t { return prob.size(); }
+
+	template<typename Gen>
+	auto sample(Gen & gen) const -> std::size_t {
+		std::uniform_int_distribution<std::size_t> columnDis(0, prob.size() - 1);
+		std::uniform_real_distribution<double> fractionDis(0.0, 1.0);
+
+		std::size_t column{ columnDis(gen) };
+		return fractionDis(gen) < prob[column] ? column : alias[column];
+	}
+};
+
+namespace selection {
+
+// writes count indices to out, in increasing order
+// all zero weights give uniform sampling
+template<typename Gen>
+auto stochasticUniversal(const double * weights, std::size_t n, std::size_t count,
+	Gen & gen, std::size_t * out) -> void {
+
+	if (count == 0 || n == 0) return;
+
+	double sum{ std::accumulate(weights, weights + n, 0.0) };
+	if (sum <= 0.0) {
+		for (std::size_t k = 0; k < count; k++)
+			out[k] = k * n / count;
+		return;
+	}
+
+	double step{ sum / count };
+	double pointer{ std::uniform_real_distribution<double>(0.0, step)(gen) };
+	double partialSum{ weights[0] };
+
+	std::size_t i{ 0 };
+	for (std::size_t k = 0; k < count; k++) {
+		while (partialSum <= pointer && i + 1 < n)
+			partialSum += weights[++i];
+		out[k] = i;
+		pointer += step;
+	}
+}
+
+// expected holds expected number of copies of every individual
+// writes count indices to out, returns number of slots filled by the bounded fallback
+template<typename Gen>
+auto remainderStochastic(const double * expected, std::size_t n, std::size_t count,
+	Gen & gen, std::size_t * out, std::vector<double> & fractionBuf,
+	std::vector<std::size_t> & orderBuf) -> std::size_t {
+
+	fractionBuf.resize(n);
+	orderBuf.resize(n);
+
+	std::size_t next{ 0 };
+	for (std::size_t i = 0; i < n; i++) {
+		std::size_t sureCopies{ static_cast<std::size_t>(expected[i]) };
+		fractionBuf[i] = expected[i] - static_cast<double>(sureCopies);
+
+		// Copy sure amount of individuals into next gen
+		while (sureCopies-- && next < count)
+			out[next++] = i;
+	}
+
+	// fractions compete in descending order, one Bernoulli trial each
+	std::iota(orderBuf.begin(), orderBuf.end(), std::size_t{ 0 });
+	std::sort(orderBuf.begin(), orderBuf.end(), [&](std::size_t a, std::size_t b) {
+		return fractionBuf[a] > fractionBuf[b];
+	});
+
+	std::uniform_real_distribution<double> fractionDis(0.0, 1.0);
+	for (std::size_t i = 0; i < n && next < count; i++) {
+		std::size_t t{ orderBuf[i] };
+		if (fractionDis(gen) < fractionBuf[t])
+			out[next++] = t;
+	}
+
+	// slots left (unlucky trials or all fractions zero) are filled in one spin
+	std::size_t left{ count - next };
+	stochasticUniversal(fractionBuf.data(), n, left, gen, out + next);
+	return left;
+}
+
+}
@@ -0,0 +1,68 @@
+/* Single Producer Single Consumer Queue
+*
+* Bounded lock-free ring buffer for passing items between exactly two
+* threads. Producer owns tail, consumer owns head, each keeps a cached copy
+* of the other index and reloads it only when the ring looks full (or
+* empty), so indices rarely bounce between cores.
+*
+* Items are copied by assignment into slots that live as long as the queue,
+* so items holding vectors reuse slot storage once the ring went around.
+*/
+
+#pragma once
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+template<typename T>
+class SpscQueue {
+	static_assert(std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>, "queue items are copied into slots by assignment");
+
+	std::unique_ptr<T[]> items;
+	std::size_t mask;
+
+	alignas(64) std::atomic<std::size_t> head{ 0 };	// next item to pop
+	std::size_t cachedTail{ 0 };						// consumer's copy of tail
+
+	alignas(64) std::atomic<std::size_t> tail{ 0 };	// next free slot
+	std::size_t cachedHead{ 0 };						// producer's copy of head
+
+public:
+	// capacity is rounded up to power of two
+	explicit SpscQueue(std::size_t capacity) : items(), mask(0) {
+		std::size_t size{ 1 };
+		while (size < capacity) size <<= 1;
+		items.reset(new T[size]);
+		mask = size - 1;
+	}
+
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue & operator=(const SpscQueue &) = delete;
+
+	auto capacity() const -> std::size_t { return mask + 1; }
+
+	// producer side, false when full
+	auto tryPush(const T & item) -> bool {
+		std::size_t t{ tail.load(std::memory_order_relaxed) };
+		if (t - cachedHead > mask) {
+			cachedHead = head.load(std::memory_order_acquire);
+			if (t - cachedHead > mask) return false;
+		}
+		items[t & mask] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side, false when empty
+	auto tryPop(T & item) -> bool {
+		std::size_t h{ head.load(std::memory_order_relaxed) };
+		if (h == cachedTail) {
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (h == cachedTail) return false;
+		}
+		item = items[h & mask];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+};
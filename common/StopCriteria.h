@@ -0,0 +1,149 @@
+/* Stop Criteria
+*
+* Ends evolution before its generation limit when continuing would only
+* burn CPU. Engine reports every generation (best fitness, evaluations
+* so far, genotype diversity when asked for) and stops when first of the
+* enabled criteria holds:
+*
+*	STAGNATION	- best fitness did not improve by more than minImprovement
+*				  during last stagnationWindow generations
+*	DIVERSITY	- mean locus diversity fell below minDiversity
+*	DEADLINE	- deadlineSeconds of wall time passed since engine start
+*	EVALUATIONS	- fitness evaluations reached maxEvaluations
+*
+* Criteria are checked after whole generations, so evaluation budget and
+* deadline may be overshot by at most one generation.
+*/
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct StopConfig {
+	int stagnationWindow{ 0 };			// generations, 0 disables
+	double minImprovement{ 0.0 };
+	double minDiversity{ 0.0 };			// in [0, 1], 0 disables
+	double deadlineSeconds{ 0.0 };		// 0 disables
+	std::uint64_t maxEvaluations{ 0 };	// 0 disables
+
+	auto enabled() const -> bool {
+		return stagnationWindow > 0 || minDiversity > 0.0 || deadlineSeconds > 0.0 || maxEvaluations > 0;
+	}
+};
+
+// NONE - no criterion fired, run ends by its generation count
+enum class StopReason {
+	NONE, STAGNATION, DIVERSITY, DEADLINE, EVALUATIONS,
+};
+
+inline auto toString(StopReason reason) -> const char * {
+	switch (reason) {
+	case StopReason::NONE: return "generation limit";
+	case StopReason::STAGNATION: return "best fitness stagnation";
+	case StopReason::DIVERSITY: return "diversity below threshold";
+	case StopReason::DEADLINE: return "wall-clock deadline";
+	case StopReason::EVALUATIONS: return "evaluation budget";
+	}
+	return "unknown";
+}
+
+// part of StopCriteria that has to survive checkpoint
+struct StopState {
+	double best{ -std::numeric_limits<double>::infinity() };
+	int improved{ 0 };		// generation of last improvement
+};
+
+class StopCriteria {
+	using clock = std::chrono::steady_clock;
+
+	StopConfig config;
+	StopState current;
+	StopReason why{ StopReason::NONE };
+	clock::time_point started{ clock::now() };
+
+public:
+	StopCriteria(const StopConfig & config = StopConfig{}) : config(config) {}
+
+	// new run: clock starts again, stagnation is forgotten
+	auto restart() -> void {
+		current = StopState{};
+		why = StopReason::NONE;
+		started = clock::now();
+	}
+
+	// engines compute diversity only when it is going to be used
+	auto needsDiversity() const -> bool { return config.minDiversity > 0.0; }
+
+	auto reason() const -> StopReason { return why; }
+	auto state() const -> StopState { return current; }
+	auto setState(const StopState & state) -> void { current = state; }
+
+	auto stopped() const -> bool { return why != StopReason::NONE; }
+
+	// true when evolution should stop after this generation, reason() tells why
+	auto update(int generation, double best, std::uint64_t evaluations, double diversity = 1.0) -> bool {
+		if (best > current.best + config.minImprovement || generation == 0) {
+			current.best = std::max(best, current.best);
+			current.improved = generation;
+		}
+
+		if (config.stagnationWindow > 0 && generation - current.improved >= config.stagnationWindow)
+			why = StopReason::STAGNATION;
+		else if (config.minDiversity > 0.0 && diversity < config.minDiversity)
+			why = StopReason::DIVERSITY;
+		else if (config.maxEvaluations > 0 && evaluations >= config.maxEvaluations)
+			why = StopReason::EVALUATIONS;
+		else if (config.deadlineSeconds > 0.0
+			&& std::chrono::duration<double>(clock::now() - started).count() >= config.deadlineSeconds)
+			why = StopReason::DEADLINE;
+
+		return why != StopReason::NONE;
+	}
+};
+
+// ones per locus over population, diversity is mean of 4 p (1 - p) over loci:
+// 1 when every locus is split half and half, 0 when population is one genotype
+class LocusCounter {
+	std::vector<std::uint32_t> ones;	// rounded up to whole words
+	std::size_t loci{ 0 };
+	std::size_t count{ 0 };
+
+public:
+	auto reset(std::size_t nLoci) -> void {
+		loci = nLoci;
+		ones.assign((nLoci + 63) / 64 * 64, 0);
+		count = 0;
+	}
+
+	// words of packed genome, bit b of word w is locus w * 64 + b (order does not matter here),
+	// bits above loci have to be zero
+	auto addWords(const std::uint64_t * words, std::size_t nWords) -> void {
+		for (std::size_t w = 0; w < nWords; w++) {
+			for (std::uint64_t bits = words[w]; bits; bits &= bits - 1)
+				ones[w * 64 + static_cast<std::size_t>(std::countr_zero(bits))]++;
+		}
+		count++;
+	}
+
+	template<typename Bool>
+	auto addBools(const Bool * alleles, std::size_t n) -> void {
+		for (std::size_t i = 0; i < n; i++)
+			ones[i] += alleles[i] ? 1u : 0u;
+		count++;
+	}
+
+	auto diversity() const -> double {
+		if (count == 0 || loci == 0) return 0.0;
+		double sum{ 0.0 };
+		for (std::size_t i = 0; i < loci; i++) {
+			double p{ static_cast<double>(ones[i]) / static_cast<double>(count) };
+			sum += 4.0 * p * (1.0 - p);
+		}
+		return sum / static_cast<double>(loci);
+	}
+};
@@ -0,0 +1,191 @@
+/* Thread Pool
+*
+* Fixed set of worker threads running parallel loops over index ranges.
+* The calling thread takes part as worker 0, so ThreadPool(1) runs
+* everything inline without any synchronization.
+*
+*	STATIC			- worker w gets w-th contiguous slice of [0, n)
+*	WORK_STEALING	- same initial slices, but a worker that runs out of
+*					  work steals the upper half of another worker's slice
+*
+* Scheduling decides only who computes which index, so any loop that writes
+* per-index results gives the same output for every thread count.
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+enum class Schedule {
+	STATIC, WORK_STEALING,
+};
+
+class ThreadPool {
+
+	// slice of work owned by one worker, guarded for stealing
+	struct alignas(64) Slice {
+		std::mutex lock;
+		std::size_t begin{ 0 };
+		std::size_t end{ 0 };
+	};
+
+	std::vector<std::thread> workers;
+	std::unique_ptr<Slice[]> slices;
+	std::size_t nThreads;
+
+	std::mutex jobLock;
+	std::condition_variable jobReady;
+	std::condition_variable jobDone;
+	std::function<void(std::size_t)> job;
+	std::size_t jobId{ 0 };
+	std::size_t running{ 0 };
+	bool stopping{ false };
+
+	auto workerLoop(std::size_t worker) -> void {
+		std::size_t seenJob{ 0 };
+		for (;;) {
+			std::unique_lock<std::mutex> guard(jobLock);
+			jobReady.wait(guard, [&] { return stopping || jobId != seenJob; });
+			if (stopping) return;
+			seenJob = jobId;
+			guard.unlock();
+
+			job(worker);
+
+			guard.lock();
+			if (--running == 0) jobDone.notify_one();
+		}
+	}
+
+	// runs task(worker) on every worker, returns when all are done
+	auto runOnAll(const std::function<void(std::size_t)> & task) -> void {
+		if (nThreads == 1) {
+			task(0);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(jobLock);
+			job = task;
+			running = nThreads - 1;
+			jobId++;
+		}
+		jobReady.notify_all();
+
+		task(0);
+
+		std::unique_lock<std::mutex> guard(jobLock);
+		jobDone.wait(guard, [&] { return running == 0; });
+	}
+
+	// takes up to grain indices from own slice, or steals half of the largest other slice
+	auto takeWork(std::size_t worker, std::size_t grain, std::size_t & begin, std::size_t & end) -> bool {
+		{
+			Slice & own{ slices[worker] };
+			std::lock_guard<std::mutex> guard(own.lock);
+			if (own.begin < own.end) {
+				begin = own.begin;
+				end = std::min(own.end, own.begin + grain);
+				own.begin = end;
+				return true;
+			}
+		}
+
+		for (;;) {
+			std::size_t victim{ nThreads };
+			std::size_t victimLeft{ 0 };
+			for (std::size_t w = 0; w < nThreads; w++) {
+				if (w == worker) continue;
+				std::lock_guard<std::mutex> guard(slices[w].lock);
+				std::size_t left{ slices[w].end - slices[w].begin };
+				if (left > victimLeft) {
+					victim = w;
+					victimLeft = left;
+				}
+			}
+			if (victim == nThreads) return false;
+
+			std::size_t stolenBegin{ 0 }, stolenEnd{ 0 };
+			{
+				Slice & other{ slices[victim] };
+				std::lock_guard<std::mutex> guard(other.lock);
+				std::size_t left{ other.end - other.begin };
+				if (left == 0) continue;	// emptied meanwhile, look again
+
+				stolenEnd = other.end;
+				stolenBegin = other.end - (left + 1) / 2;
+				other.end = stolenBegin;
+			}
+
+			begin = stolenBegin;
+			end = std::min(stolenEnd, stolenBegin + grain);
+
+			Slice & own{ slices[worker] };
+			std::lock_guard<std::mutex> guard(own.lock);
+			own.begin = end;
+			own.end = stolenEnd;
+			return true;
+		}
+	}
+
+public:
+	// threads = 0 uses all hardware threads
+	explicit ThreadPool(std::size_t threads = 0) :
+		workers(), slices(), nThreads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+
+		slices.reset(new Slice[nThreads]);
+		for (std::size_t w = 1; w < nThreads; w++)
+			workers.emplace_back(&ThreadPool::workerLoop, this, w);
+	}
+
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> guard(jobLock);
+			stopping = true;
+		}
+		jobReady.notify_all();
+		for (std::thread & t : workers) t.join();
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	auto size() const -> std::size_t { return nThreads; }
+
+	// calls body(begin, end, worker) over disjoint ranges covering [0, n)
+	template<typename Body>
+	auto parallelFor(std::size_t n, Schedule schedule, std::size_t grain, Body && body) -> void {
+		if (n == 0) return;
+		grain = std::max<std::size_t>(grain, 1);
+
+		if (nThreads == 1 || n <= grain) {
+			body(std::size_t{ 0 }, n, std::size_t{ 0 });
+			return;
+		}
+
+		for (std::size_t w = 0; w < nThreads; w++) {
+			slices[w].begin = n * w / nThreads;
+			slices[w].end = n * (w + 1) / nThreads;
+		}
+
+		if (schedule == Schedule::STATIC) {
+			runOnAll([&](std::size_t worker) {
+				if (slices[worker].begin < slices[worker].end)
+					body(slices[worker].begin, slices[worker].end, worker);
+			});
+			return;
+		}
+
+		runOnAll([&](std::size_t worker) {
+			std::size_t begin{ 0 }, end{ 0 };
+			while (takeWork(worker, grain, begin, end))
+				body(begin, end, worker);
+		});
+	}
+};
@@ -3,13 +3,18 @@
 using namespace geo;
 
 Pathfinder::Pathfinder() 
-    : window(sf::VideoMode(1920, 1000), "Simulation", sf::Style::Fullscreen), view(sf::FloatRect(0.f, 0.f, 1920.f, 1000.f)), font(), 
-        rng{std::chrono::high_resolution_clock::now().time_since_epoch().count()}, 
+    : 
+#ifndef PATHFINDER_HEADLESS
+        window(sf::VideoMode(1920, 1000), "Simulation", sf::Style::Fullscreen), view(sf::FloatRect(0.f, 0.f, 1920.f, 1000.f)), font(), 
+#endif
+        streams{static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())}, rng{streams(0, 0, RngOp::EVALUATION)}, 
         xDistr{MIN_X, MAX_X}, yDistr{MIN_Y, MAX_Y}, fraction{0, 1} {
 
+#ifndef PATHFINDER_HEADLESS
     window.setView(view);
     font.loadFromFile("Bebas-Regular.otf");
     // window.setKeyRepeatEnabled(false);
+#endif
 }
 
 double Pathfinder::binExp(double a, int t) {
@@ -23,6 +28,7 @@ double Pathfinder::binExp(double a, int t) {
 }
 
 void Pathfinder::draw(Pathfinder::Population pop, int bestIndividualsPrintCnt, bool pauseAfter = false) {
+#ifndef PATHFINDER_HEADLESS
     if ( !window.isOpen() ) return; 
     window.clear(sf::Color::Black); 
 
@@ -113,14 +119,18 @@ void Pathfinder::draw(Pathfinder::Population pop, int bestIndividualsPrintCnt, b
             }
         }
     }
+#endif
 }
 
 void Pathfinder::test(Circle & queen, std::vector<Circle>& sites) {
     int nOfGenerations { 300 };
+    std::uint32_t trial { 0 };
 
-    while ( window.isOpen() ) {
+    while ( running() ) {
+        rng = streams(trial++, 0, RngOp::EVALUATION);
         Point dest { getRandomPoint() };
         std::vector<Point> path { findBestPath(queen, dest, sites, nOfGenerations) };
+        if ( headless ) break;
     }
 }
 
@@ -139,7 +149,7 @@ std::vector<Point> Pathfinder::findBestPath(Circle& queen, Point destination, st
         calcStats(populations.back());
     }
 
-    while ( window.isOpen() && nOfGen()  < nOfGenerations ) {
+    while ( running() && nOfGen()  < nOfGenerations ) {
         populations.emplace_back(popSize);
         inherit( populations[nOfGen() - 1], populations[nOfGen() - 2]); 
         evaluate(populations.back());
@@ -261,7 +271,9 @@ double Pathfinder::clear(chrom_t& chrom) {
 }
 
 void Pathfinder::randomize(Population &pop) {
+    std::uint32_t index { 0 };
     for (Individual& ind : pop.individuals ) {
+        rng = streams(nOfGen(), index++, RngOp::INIT);
         int nodes = std::uniform_int_distribution<int>(2, getMaxChromLen())(rng);
         nodes = std::max(0, nodes - 2);
 
@@ -306,7 +318,9 @@ const Pathfinder::Individual& Pathfinder::Population::getBest() {
 void Pathfinder::evaluate(Population& pop) {
 
     fitness_t maxCost = -1.0;
+    std::uint32_t index { 0 };
     for ( Individual &ind : pop.individuals ) {
+        rng = streams(nOfGen(), index++, RngOp::MUTATION);
         remove(ind.chrom); insert(ind.chrom);
         swap(ind.chrom); 
         smallMutate(ind.chrom);
@@ -331,9 +345,11 @@ void Pathfinder::evaluate(Population& pop) {
 void Pathfinder::inherit(Population& curr, Population& last) {
     curr.individuals[0] = last.getBest();
     curr.individuals[1] = last.getBest();
+    rng = streams(nOfGen(), 0, RngOp::CROSSING);
     cross(curr.individuals[0].chrom, curr.individuals[1].chrom);
 
     for (int i = 2; i < curr.size; i += 2) {
+        rng = streams(nOfGen(), i, RngOp::SELECTION);
         curr.individuals[i] = select(last);
         curr.individuals[i+1] = select(last);
         cross(curr.individuals[i].chrom, curr.individuals[i + 1].chrom);
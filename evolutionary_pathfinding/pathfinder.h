@@ -3,15 +3,19 @@
 * structure for evolutionary pathfinding
 * enviroment is rectangle of constant size 
 * every obstacle (including robot) is a circle
+* PATHFINDER_HEADLESS builds it without SFML window (benchmarks)
 */
 
 #ifndef PATHFINDER_213888_H
 #define PATHFINDER_213888_H
 
 #include "geometry.h"
+#include "../common/CounterRng.h"
 
+#ifndef PATHFINDER_HEADLESS
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#endif
 
 #include <iostream>
 #include <iomanip>
@@ -24,9 +28,11 @@ class Pathfinder {
 private:
 
 // DEBUG SFML
+#ifndef PATHFINDER_HEADLESS
 sf::RenderWindow window;
 sf::View view;
 sf::Font font;
+#endif
 
 // USED TYPES
 using chrom_t = std::vector<std::pair<geo::Point, bool>>;
@@ -51,7 +57,10 @@ const int MAX_Y = 1000;
 const int MIN_X = 0; 
 const int MIN_Y = 0;
 
-std::mt19937 rng;
+// rng is rekeyed to stream (seed, generation, individual, operator) before every operator,
+// test destinations come from EVALUATION streams, which no operator uses
+RngStreams streams;
+CounterRng rng;
 std::uniform_int_distribution<int> xDistr;
 std::uniform_int_distribution<int> yDistr;
 std::uniform_real_distribution<double> fraction;
@@ -95,6 +104,13 @@ geo::Point dest;
 
     // Inline functions
     size_t nOfGen() { return populations.size(); }
+#ifndef PATHFINDER_HEADLESS
+    static constexpr bool headless = false;
+    bool running() { return window.isOpen(); }
+#else
+    static constexpr bool headless = true;
+    bool running() { return true; }
+#endif
     size_t getMaxChromLen() { return ( local? nOfGen() : obstacles.size() ); }
     geo::Point getRandomPoint() { return geo::Point(xDistr(rng), yDistr(rng)); }
     double binExp(double a, int t);
@@ -139,6 +155,9 @@ public:
 
     void test(geo::Circle& queen, std::vector<geo::Circle>& sites);
 
+    // fixes random streams, by default they are seeded from clock
+    void setSeed(std::uint64_t seed) { streams = RngStreams{ seed }; rng = streams(0, 0, RngOp::EVALUATION); }
+
     static Pathfinder& getPathfinder() {
         static Pathfinder pathfinder;
         return pathfinder;
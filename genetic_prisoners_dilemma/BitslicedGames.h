@@ -0,0 +1,241 @@
+/* Bitsliced Games
+*
+* Many prisoner's dilemma games in lockstep, one game per bit lane: 64
+* lanes in a 64-bit word, 256 in an AVX2 register (compiled with -mavx2
+* or GP_NATIVE, 64-bit words otherwise, both give the same scores).
+*
+* Every value of a game is a bit, so each is kept as a slice, a word
+* holding that bit of every lane:
+*
+*	answers	- 64 slices per side, slice k is answer k of each lane's strategy
+*	view	- 6 slices per side, same bits as GameKernel.h register
+*
+* Move of a lane is its answer at its view, a 64 to 1 multiplexer over
+* answer slices driven by view slices: 63 selects of 3 bitwise ops, first
+* level of answer pairs prepared once per block, evaluated depth first so
+* it fits in registers. New view is the old one shifted by 2 slices, which
+* only renames words.
+*
+* Scores are not added per round. Lanes count rounds where the first
+* player cooperated (a), the second one did (b) and both did (c) in
+* bitsliced 8-bit counters, and with payoffs (D, D) 1, (D, C) 5, (C, D) 0,
+* (C, C) 3 the scores of n rounds are
+*
+*	first	= n - a + 4b - c
+*	second	= n - b + 4a - c
+*
+* Counters are flushed to scores every 255 rounds, through one 64 x 64 bit
+* transpose per 64 lanes.
+*/
+
+#pragma once
+#include "GameKernel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace gap {
+
+// game of strategies[first] against strategies[second]
+struct GamePair {
+	std::uint32_t first{ 0 };
+	std::uint32_t second{ 0 };
+};
+
+namespace bitsliced {
+
+// 64 lanes in one 64-bit word
+struct Lanes64 {
+	static constexpr std::size_t words{ 1 };
+	std::uint64_t v;
+
+	static auto load(const std::uint64_t * p) -> Lanes64 { return { *p }; }
+	auto store(std::uint64_t * p) const -> void { *p = v; }
+
+	friend auto operator&(Lanes64 a, Lanes64 b) -> Lanes64 { return { a.v & b.v }; }
+	friend auto operator^(Lanes64 a, Lanes64 b) -> Lanes64 { return { a.v ^ b.v }; }
+};
+
+#ifdef __AVX2__
+// 256 lanes in one AVX2 register, word w holds lanes [64w, 64w + 64)
+struct Lanes256 {
+	static constexpr std::size_t words{ 4 };
+	__m256i v;
+
+	static auto load(const std::uint64_t * p) -> Lanes256 { return { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)) }; }
+	auto store(std::uint64_t * p) const -> void { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+	friend auto operator&(Lanes256 a, Lanes256 b) -> Lanes256 { return { _mm256_and_si256(a.v, b.v) }; }
+	friend auto operator^(Lanes256 a, Lanes256 b) -> Lanes256 { return { _mm256_xor_si256(a.v, b.v) }; }
+};
+
+using Widest = Lanes256;
+#else
+using Widest = Lanes64;
+#endif
+
+// games played at once by play
+constexpr std::size_t lanes{ 64 * Widest::words };
+
+constexpr std::size_t counterBits{ 8 };
+constexpr std::size_t flushRounds{ (std::size_t{ 1 } << counterBits) - 1 };
+
+// bit c of m[r] goes to bit r of m[c]
+inline auto transpose(std::array<std::uint64_t, 64> & m) -> void {
+	std::uint64_t mask{ 0x00000000FFFFFFFFull };
+	for (std::size_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+		for (std::size_t k = 0; k < 64; k = (k + j + 1) & ~j) {
+			std::uint64_t t{ ((m[k] >> j) ^ m[k + j]) & mask };
+			m[k] ^= t << j;
+			m[k + j] ^= t;
+		}
+	}
+}
+
+namespace detail {
+
+// answer at view of every lane, over answer slices [k << (Bit + 1), (k + 1) << (Bit + 1)),
+// base[k] / diff[k] are slices 2k and 2k ^ 2k+1; depth first, so few registers stay live
+template<std::size_t Bit, typename V>
+inline auto select(const V * base, const V * diff, const V * view, std::size_t k) -> V {
+	if constexpr (Bit == 0) {
+		return base[k] ^ (diff[k] & view[0]);
+	}
+	else {
+		V low{ select<Bit - 1>(base, diff, view, 2 * k) };
+		V high{ select<Bit - 1>(base, diff, view, 2 * k + 1) };
+		return low ^ ((low ^ high) & view[Bit]);
+	}
+}
+
+template<typename V>
+inline auto move(const V * base, const V * diff, const V * view) -> V {
+	return select<5>(base, diff, view, 0);
+}
+
+// adds bit of every lane to its counter
+template<typename V>
+inline auto count(V * counter, V bit) -> void {
+	for (std::size_t k = 0; k < counterBits; k++) {
+		V carry{ counter[k] & bit };
+		counter[k] = counter[k] ^ bit;
+		bit = carry;
+	}
+}
+
+}
+
+// plays pairs.size() <= 64 * V::words games, scores[i] is score of pairs[i]
+template<typename V>
+auto playBlock(std::span<const PackedStrategy> strategies, std::span<const GamePair> pairs,
+	std::size_t rounds, std::span<GameScore> scores) -> void {
+	constexpr std::size_t W{ V::words };
+	const std::size_t n{ pairs.size() };
+
+	// slices of lanes: [slice][word]
+	std::uint64_t answers[2][64][W];
+	std::uint64_t views[2][6][W]{};
+	std::array<std::uint64_t, 64> m;
+	for (std::size_t side = 0; side < 2; side++) {
+		for (std::size_t w = 0; w < W; w++) {
+			for (std::size_t l = 0; l < 64; l++) {
+				std::size_t lane{ 64 * w + l };
+				if (lane >= n) {
+					m[l] = 0;
+					continue;
+				}
+				const PackedStrategy & s{ strategies[side == 0 ? pairs[lane].first : pairs[lane].second] };
+				m[l] = s.answers;
+				for (std::size_t i = 0; i < 6; i++) views[side][i][w] |= static_cast<std::uint64_t>((s.view >> i) & 1u) << l;
+			}
+			transpose(m);
+			for (std::size_t k = 0; k < 64; k++) answers[side][k][w] = m[k];
+		}
+	}
+
+	V baseA[32], diffA[32], baseB[32], diffB[32];
+	for (std::size_t k = 0; k < 32; k++) {
+		baseA[k] = V::load(answers[0][2 * k]);
+		diffA[k] = baseA[k] ^ V::load(answers[0][2 * k + 1]);
+		baseB[k] = V::load(answers[1][2 * k]);
+		diffB[k] = baseB[k] ^ V::load(answers[1][2 * k + 1]);
+	}
+	V viewA[6], viewB[6];
+	for (std::size_t i = 0; i < 6; i++) {
+		viewA[i] = V::load(views[0][i]);
+		viewB[i] = V::load(views[1][i]);
+	}
+
+	for (std::size_t l = 0; l < n; l++) scores[l] = GameScore{};
+
+	for (std::size_t played = 0; played < rounds;) {
+		std::size_t chunk{ std::min(flushRounds, rounds - played) };
+
+		// counters of cooperations: first, second, both
+		V coopA[counterBits], coopB[counterBits], coopBoth[counterBits];
+		V zero{ viewA[0] ^ viewA[0] };
+		for (std::size_t k = 0; k < counterBits; k++) coopA[k] = coopB[k] = coopBoth[k] = zero;
+
+		for (std::size_t r = 0; r < chunk; r++) {
+			V moveA{ detail::move(baseA, diffA, viewA) };
+			V moveB{ detail::move(baseB, diffB, viewB) };
+			detail::count(coopA, moveA);
+			detail::count(coopB, moveB);
+			detail::count(coopBoth, moveA & moveB);
+
+			// view bit 1 is own last move, bit 0 the other's
+			for (std::size_t i = 5; i >= 2; i--) {
+				viewA[i] = viewA[i - 2];
+				viewB[i] = viewB[i - 2];
+			}
+			viewA[1] = moveA;
+			viewA[0] = moveB;
+			viewB[1] = moveB;
+			viewB[0] = moveA;
+		}
+		played += chunk;
+
+		// transposed counters: bits [0, 8) a, [8, 16) b, [16, 24) c of lane
+		std::uint64_t counters[3 * counterBits][W];
+		for (std::size_t k = 0; k < counterBits; k++) {
+			coopA[k].store(counters[k]);
+			coopB[k].store(counters[counterBits + k]);
+			coopBoth[k].store(counters[2 * counterBits + k]);
+		}
+		for (std::size_t w = 0; w < W && 64 * w < n; w++) {
+			m.fill(0);
+			for (std::size_t k = 0; k < 3 * counterBits; k++) m[k] = counters[k][w];
+			transpose(m);
+			for (std::size_t l = 0; l < 64 && 64 * w + l < n; l++) {
+				std::uint64_t a{ m[l] & flushRounds };
+				std::uint64_t b{ (m[l] >> counterBits) & flushRounds };
+				std::uint64_t c{ (m[l] >> (2 * counterBits)) & flushRounds };
+				GameScore & score{ scores[64 * w + l] };
+				score.first += chunk - a + 4 * b - c;
+				score.second += chunk - b + 4 * a - c;
+			}
+		}
+	}
+}
+
+// plays any number of games, lanes at a time, scores[i] is score of pairs[i]
+inline auto play(std::span<const PackedStrategy> strategies, std::span<const GamePair> pairs,
+	std::size_t rounds, std::span<GameScore> scores) -> void {
+	for (std::size_t begin = 0; begin < pairs.size(); begin += lanes) {
+		std::size_t n{ std::min(lanes, pairs.size() - begin) };
+		// short tail does not need wide registers
+		if (n <= 64) playBlock<Lanes64>(strategies, pairs.subspan(begin, n), rounds, scores.subspan(begin, n));
+		else playBlock<Widest>(strategies, pairs.subspan(begin, n), rounds, scores.subspan(begin, n));
+	}
+}
+
+}
+
+}
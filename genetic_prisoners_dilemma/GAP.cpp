@@ -2,16 +2,64 @@
 
 using namespace gap;
 
-GAP::GAP(unsigned int seed) : seed(seed), populations(1),
-	gen(seed) {
+template<size_t PopSize>
+GAP<PopSize>::GAP(unsigned int seed) : 
+	GAP([&] {
+		GAPConfig config;
+		config.seed = seed;
+		return config;
+	}()) {}
+
+template<size_t PopSize>
+GAP<PopSize>::GAP(const GAPConfig & config) : 
+	popSize(PopSize == dynamicSize ? popSizeOf(config) : PopSize), gameRounds(config.gameRounds),
+	pMut(config.pMut), pCross(config.pCross), gameMode(config.game), seed(config.seed), 
+	buffers(2, Population(popSize)), history(config.history), streams(seed), parents(popSize), packed(popSize), pool(config.threads), tileSize(std::max<size_t>(config.tileSize, 1)),
+	gameCache(config.gameCache), order(popSize), distinctOf(popSize), checkpoint(config.checkpoint), stopping(config.stop) {
+
+	if (PopSize != dynamicSize && config.popSize != popSize)
+		std::cerr << "Config Error! popSize = " << config.popSize << " ignored, fixed size is " << popSize << '\n';
+
+	if (!config.trace.path.empty())
+		tracer = std::make_unique<TraceWriter>(config.trace, TraceEngine::GAP, popSize, chromLen,
+			TraceGenomeOrder::LOW_FIRST);
+
+	size_t blocks{ (popSize + tileSize - 1) / tileSize };
+	for (size_t first = 0; first < blocks; first++)
+		for (size_t second = first; second < blocks; second++)
+			tiles.emplace_back(first, second);
+	scoreRows.assign(pool.size(), std::vector<std::uint64_t>(popSize, 0));
+	if (gameMode == GameMode::BITSLICED) {
+		tilePairs.resize(pool.size());
+		tileScores.resize(pool.size());
+	}
+
 	std::bernoulli_distribution flip{ 0.5 };
-	for (GeneticPlayer & gp : populations.back().pop) {
+	std::uint32_t index{ 0 };
+	for (GeneticPlayer & gp : currPop().pop) {
+		CounterRng rng{ streams(0, index++, RngOp::INIT) };
 		for (move_t & move : gp.strategy)
-			if (flip(gen)) move = cooperate;
+			if (flip(rng)) move = cooperate;
+	}
+
+	if (!checkpoint.path.empty() && checkpoint.resume && std::filesystem::exists(checkpoint.path)) {
+		if (loadCheckpoint(checkpoint.path))
+			std::cerr << "Resumed from " << checkpoint.path << " at generation " << generation << '\n';
+		else
+			std::cerr << "Checkpoint Error! " << checkpoint.path << " does not match config, starting from generation 0\n";
 	}
 }
 
-auto GAP::payoff(const round_t & round) -> std::pair<fitness_t, fitness_t> {
+template<size_t PopSize>
+auto GAP<PopSize>::popSizeOf(const GAPConfig & config) -> size_t {
+	// fitness is score averaged over popSize - 1 opponents
+	if (config.popSize >= 2) return config.popSize;
+	std::cerr << "Config Error! popSize = " << config.popSize << " ignored, expected at least 2, using " << GAPConfig{}.popSize << '\n';
+	return GAPConfig{}.popSize;
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::payoff(const round_t & round) -> std::pair<fitness_t, fitness_t> {
 	std::pair<fitness_t, fitness_t> payoff;
 	if (round.first == cooperate) {
 		if (round.second == cooperate)
@@ -27,7 +75,8 @@ auto GAP::payoff(const round_t & round) -> std::pair<fitness_t, fitness_t> {
 	return payoff;
 }
 
-auto GAP::getStrategyIndex(const round_t & threeAgo, const round_t & twoAgo, const round_t & last)->size_t {
+template<size_t PopSize>
+auto GAP<PopSize>::getStrategyIndex(const round_t & threeAgo, const round_t & twoAgo, const round_t & last)->size_t {
 	size_t index{ 0 };
 
 	// index is 6 bit number, 2^6 => [0, 63] value
@@ -48,7 +97,8 @@ auto GAP::getStrategyIndex(const round_t & threeAgo, const round_t & twoAgo, con
 	return index;
 }
 
-auto GAP::playGame(GeneticPlayer & p1, GeneticPlayer & p2) -> void {
+template<size_t PopSize>
+auto GAP<PopSize>::playGame(GeneticPlayer & p1, GeneticPlayer & p2) -> void {
 	std::vector<round_t> p1rounds;
 	std::vector<round_t> p2rounds;
 
@@ -81,10 +131,59 @@ auto GAP::playGame(GeneticPlayer & p1, GeneticPlayer & p2) -> void {
 	p2.fitness += p2fitness;
 }
 
-auto GAP::tournament(Population & pop) -> void {
-	for (size_t i = 0; i < popSize; i++) {
-		for (size_t j = i + 1; j < popSize; j++) {
-			playGame(pop.pop[i], pop.pop[j]);
+template<size_t PopSize>
+auto GAP<PopSize>::playPacked(const PackedStrategy & first, const PackedStrategy & second) const -> GameScore {
+	if (gameMode == GameMode::CYCLE) return kernel::playCycle(first, second, gameRounds);
+	return kernel::play(first, second, gameRounds);
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::playMatch(const strategy_t & first, const strategy_t & second) -> std::pair<fitness_t, fitness_t> {
+	if (gameMode != GameMode::SIMULATE) {
+		GameScore score{ playPacked(kernel::pack(first), kernel::pack(second)) };
+		return { static_cast<fitness_t>(score.first), static_cast<fitness_t>(score.second) };
+	}
+
+	GeneticPlayer p1, p2;
+	p1.strategy = first;
+	p2.strategy = second;
+	playGame(p1, p2);
+	return { p1.fitness, p2.fitness };
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::tournament(Population & pop) -> void {
+	if (gameMode != GameMode::SIMULATE) {
+		for (size_t i = 0; i < popSize; i++)
+			packed[i] = kernel::pack(pop.pop[i].strategy);
+	}
+
+	if (gameMode != GameMode::SIMULATE && gameCache.enabled()) {
+		cachedTournament(pop);
+	}
+	else if (gameMode != GameMode::SIMULATE) {
+		pool.parallelFor(tiles.size(), Schedule::WORK_STEALING, 1, [&](size_t begin, size_t end, size_t worker) {
+			for (size_t t = begin; t < end; t++) playTile(t, worker);
+		});
+
+		// integer sums do not depend on which worker played which game,
+		// so fitness is the same for every thread count
+		pool.parallelFor(popSize, Schedule::STATIC, 1024, [&](size_t begin, size_t end, size_t) {
+			for (size_t p = begin; p < end; p++) {
+				std::uint64_t total{ 0 };
+				for (std::vector<std::uint64_t> & row : scoreRows) {
+					total += row[p];
+					row[p] = 0;
+				}
+				pop.pop[p].fitness += static_cast<fitness_t>(total);
+			}
+		});
+	}
+	else {
+		for (size_t i = 0; i < popSize; i++) {
+			for (size_t j = i + 1; j < popSize; j++) {
+				playGame(pop.pop[i], pop.pop[j]);
+			}
 		}
 	}
 
@@ -94,78 +193,318 @@ auto GAP::tournament(Population & pop) -> void {
 	}
 }
 
-auto GAP::evolve(int generations) -> void {
-	tournament(currPop());
-	currPop().calcStats();
+template<size_t PopSize>
+auto GAP<PopSize>::cachedTournament(Population & pop) -> void {
+	std::iota(order.begin(), order.end(), size_t{ 0 });
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		const PackedStrategy & x{ packed[a] };
+		const PackedStrategy & y{ packed[b] };
+		if (x.answers != y.answers) return x.answers < y.answers;
+		if (x.view != y.view) return x.view < y.view;
+		return a < b;
+	});
+
+	distinct.clear();
+	copies.clear();
+	for (size_t p : order) {
+		const PackedStrategy & s{ packed[p] };
+		if (distinct.empty() || distinct.back().answers != s.answers || distinct.back().view != s.view) {
+			distinct.push_back(s);
+			copies.push_back(0);
+		}
+		copies.back()++;
+		distinctOf[p] = static_cast<std::uint32_t>(distinct.size() - 1);
+	}
+
+	auto play = [&](const PackedStrategy & first, const PackedStrategy & second) { return playPacked(first, second); };
+	distinctTotals.assign(distinct.size(), 0);
+	for (size_t u = 0; u < distinct.size(); u++) {
+		// copies of one strategy play each other, same moves give both the same score
+		if (copies[u] > 1)
+			distinctTotals[u] += (copies[u] - 1) * gameCache.get(distinct[u], distinct[u], play).first;
+
+		for (size_t v = u + 1; v < distinct.size(); v++) {
+			GameScore score{ gameCache.get(distinct[u], distinct[v], play) };
+			distinctTotals[u] += copies[v] * score.first;
+			distinctTotals[v] += copies[u] * score.second;
+		}
+	}
+
+	// same integer totals as full round robin, so same fitness
+	for (size_t p = 0; p < popSize; p++)
+		pop.pop[p].fitness += static_cast<fitness_t>(distinctTotals[distinctOf[p]]);
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::playTile(size_t tile, size_t worker) -> void {
+	std::vector<std::uint64_t> & scores{ scoreRows[worker] };
+	size_t firstBegin{ tiles[tile].first * tileSize };
+	size_t firstEnd{ std::min(firstBegin + tileSize, popSize) };
+	size_t secondBegin{ tiles[tile].second * tileSize };
+	size_t secondEnd{ std::min(secondBegin + tileSize, popSize) };
+
+	if (gameMode == GameMode::BITSLICED) {
+		std::vector<GamePair> & pairs{ tilePairs[worker] };
+		std::vector<GameScore> & results{ tileScores[worker] };
+		pairs.clear();
+		for (size_t i = firstBegin; i < firstEnd; i++)
+			for (size_t j = std::max(secondBegin, i + 1); j < secondEnd; j++)
+				pairs.push_back(GamePair{ static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j) });
+		results.resize(pairs.size());
+
+		bitsliced::play(packed, pairs, gameRounds, results);
+		for (size_t g = 0; g < pairs.size(); g++) {
+			scores[pairs[g].first] += results[g].first;
+			scores[pairs[g].second] += results[g].second;
+		}
+		return;
+	}
+
+	for (size_t i = firstBegin; i < firstEnd; i++) {
+		// tile on diagonal holds each pair once, above it
+		for (size_t j = std::max(secondBegin, i + 1); j < secondEnd; j++) {
+			GameScore score{ playPacked(packed[i], packed[j]) };
+			scores[i] += score.first;
+			scores[j] += score.second;
+		}
+	}
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::evolve(int generations) -> void {
+	step(0);
+	while (generation < generations && !stopping.stopped()) {
+		std::cerr << "generation: #" << generation + 1 << '\n';
+		step(1);
+	}
+
+	if (stopping.stopped())
+		std::cerr << "Stopped at generation " << generation << ": " << toString(stopping.reason()) << '\n';
+	if (gameCache.enabled()) {
+		GameCacheStats cache{ gameCache.stats() };
+		std::cerr << "Game cache hits:" << cache.hits << " misses:" << cache.misses << " evictions:" << cache.evictions
+			<< " hit rate:" << 100.0 * cache.hits / std::max<std::uint64_t>(cache.hits + cache.misses, 1) << "%"
+			<< " distinct strategies:" << distinct.size() << " of " << popSize << '\n';
+	}
+	debug();
+	exportPlayer(getBestPlayer(currPop()));
+}
 
-	for (int i = 1; i <= generations; i++) {
-		std::cerr << "generation: #" << i << '\n';
-		Population next;
+template<size_t PopSize>
+auto GAP<PopSize>::step(int generations) -> void {
+	if (!started) {
+		tournament(currPop());
+		currPop().calcStats();
+		started = true;
+	}
 
-		selection(next);
+	for (int i = 0; i < generations && !stopping.stopped(); i++) {
+		generation++;
+		Population & next{ nextPop() };
+
+		selection();
 		crossing(next);
 		mutation(next);
 
 		tournament(next);
 		next.calcStats();
 
-		populations.push_back(next);
+		history.record(generation, next);
+		currIndex ^= 1;
+		if (tracer) traceGeneration();
+
+		// criteria first, so checkpoint carries their state of this generation
+		bool stop{ shouldStop() };
+		if (!checkpoint.path.empty() && checkpoint.interval > 0 && generation % checkpoint.interval == 0)
+			saveCheckpoint();
+		if (stop) break;
 	}
+}
 
-	debug();
-	exportPlayer(getBestPlayer(currPop()));
+template<size_t PopSize>
+auto GAP<PopSize>::stats() -> GAPStats {
+	const Population & pop{ currPop() };
+	return GAPStats{ generation, pop.sum, pop.avg, pop.max, pop.min, gamesPlayed(), distinct.size() };
 }
 
-auto GAP::selection(Population & next) -> void {
-	std::array<fitness_t, popSize> prefSum{ };
-	fitness_t currSum{0.0};
-	size_t index{ 0 };
+template<size_t PopSize>
+auto GAP<PopSize>::shouldStop() -> bool {
+	const Population & pop{ currPop() };
+	double diversity{ 1.0 };
+	if (stopping.needsDiversity()) {
+		loci.reset(chromLen);
+		for (const GeneticPlayer & gp : pop.pop)
+			loci.addBools(gp.strategy.data(), chromLen);
+		diversity = loci.diversity();
+	}
+	return stopping.update(generation, pop.max, gamesPlayed(), diversity);
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::gamesPlayed() const -> std::uint64_t {
+	return static_cast<std::uint64_t>(popSize) * (popSize - 1) / 2 * static_cast<std::uint64_t>(generation + 1);
+}
 
-	for (const GeneticPlayer & gp : populations.back().pop) {
-		currSum += gp.fitness;
-		prefSum[index++] = currSum;
+template<size_t PopSize>
+auto GAP<PopSize>::traceGeneration() -> void {
+	const Population & pop{ currPop() };
+	tracer->add(TraceRow{ generation, gamesPlayed(), pop.max, pop.avg, pop.min });
+	if (!tracer->tracesGenomes()) return;
+
+	for (size_t i = 0; i < popSize; i++) {
+		const GeneticPlayer & gp{ pop.pop[i] };
+		tracer->fitness(i) = gp.fitness;
+		std::span<std::uint64_t> words{ tracer->genome(i) };
+		std::fill(words.begin(), words.end(), 0);
+		for (size_t m = 0; m < chromLen; m++)
+			words[m / 64] |= static_cast<std::uint64_t>(gp.strategy[m]) << (m % 64);
+	}
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::saveCheckpoint() -> void {
+	saveCheckpoint(checkpoint.path);
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::saveCheckpoint(const std::string & path) -> void {
+	const Population & pop{ currPop() };
+
+	CheckpointOut out{ checkpointBuf, CheckpointEngine::GAP };
+	out.put(popSize);
+	out.put(gameRounds);
+	out.put(seed);
+	out.put(started);
+	out.put(generation);
+	out.put(mutations);
+	out.put(crossings);
+	out.put(stopping.state());
+
+	const fitness_t stats[]{ pop.sum, pop.avg, pop.max, pop.min };
+	out.put(stats, 4);
+	for (const GeneticPlayer & gp : pop.pop) {
+		out.put(gp.fitness);
+		out.put(gp.strategy);
 	}
+	out.put(pop.prefixSum.data(), pop.prefixSum.size());
 
-	for (GeneticPlayer & gp : next.pop) {
-		fitness_t choice{ fractDis(gen) * populations.back().sum };
+	if (!checkpointWriter) checkpointWriter = std::make_unique<CheckpointWriter>();
+	checkpointWriter->submit(path, checkpointBuf);
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::loadCheckpoint(const std::string & path) -> bool {
+	CheckpointIn in{ path, CheckpointEngine::GAP };
+	if (!in.expect(popSize) || !in.expect(gameRounds)) return false;
+
+	unsigned int savedSeed{};
+	bool savedStarted{};
+	int savedGeneration{}, savedCrossings{};
+	std::uint64_t savedMutations{};
+	in.get(savedSeed);
+	in.get(savedStarted);
+	in.get(savedGeneration);
+	in.get(savedMutations);
+	in.get(savedCrossings);
+	StopState savedStop{};
+	in.get(savedStop);
+
+	// read into a copy, so a broken file leaves engine as it was
+	Population pop{ currPop() };
+	fitness_t stats[4]{};
+	in.get(stats, 4);
+	pop.sum = stats[0];
+	pop.avg = stats[1];
+	pop.max = stats[2];
+	pop.min = stats[3];
+	for (size_t i = 0; i < pop.pop.size(); i++) {
+		in.get(pop.pop[i].fitness);
+		in.get(pop.pop[i].strategy);
+		pop.fitness[i] = pop.pop[i].fitness;
+	}
+	in.get(pop.prefixSum.data(), pop.prefixSum.size());
+	if (!in.complete()) return false;
+
+	currPop() = std::move(pop);
+	seed = savedSeed;
+	streams = RngStreams(seed);
+	started = savedStarted;
+	generation = savedGeneration;
+	mutations = savedMutations;
+	crossings = savedCrossings;
+	stopping.setState(savedStop);
+	return true;
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::selection() -> void {
+	const PopulationBuffer<fitness_t, PopSize> & prefSum{ currPop().prefixSum };
+
+	for (size_t i = 0; i < popSize; i++) {
+		CounterRng rng{ streams(generation, i, RngOp::SELECTION) };
+		fitness_t choice{ fractDis(rng) * currPop().sum };
 		auto it{ std::lower_bound(prefSum.begin(), prefSum.end(), choice) };
-		uint32_t x{ std::distance(prefSum.begin(), it) };
-		
-		gp = populations.back().pop[x];
+		// sum is added in other order than prefix sums, choice may land past the last one by rounding
+		parents[i] = std::min(static_cast<size_t>(std::distance(prefSum.begin(), it)), popSize - 1);
 	}
 }
 
-auto GAP::crossing(Population & next) -> void {
-	for (int i = 0; i < popSize; i += 2) {
-		if (!cross(gen)) continue;
+template<size_t PopSize>
+auto GAP<PopSize>::crossing(Population & next) -> void {
+	const Population & curr{ currPop() };
+
+	// children start with fitness of their parent, tournament adds to it
+	for (size_t i = 0; i < popSize; i++)
+		next.pop[i].fitness = curr.pop[parents[i]].fitness;
+
+	for (size_t i = 0; i < popSize; i += 2) {
+		const chromosome_t & chrom1{ curr.pop[parents[i]].strategy };
+
+		// odd population, last player passes without crossing
+		if (i + 1 == popSize) {
+			next.pop[i].strategy = chrom1;
+			break;
+		}
+		const chromosome_t & chrom2{ curr.pop[parents[i + 1]].strategy };
+		chromosome_t & child1{ next.pop[i].strategy };
+		chromosome_t & child2{ next.pop[i + 1].strategy };
+
+		CounterRng rng{ streams(generation, i, RngOp::CROSSING) };
+		if (!cross(rng)) {
+			child1 = chrom1;
+			child2 = chrom2;
+			continue;
+		}
 		
 		crossings++;
-		size_t crossPoint{ crossPointDis(gen) };
+		size_t crossPoint{ crossPointDis(rng) };
 
-		chromosome_t & chrom1{ next.pop[i].strategy };
-		chromosome_t & chrom2{ next.pop[i + 1].strategy };
-
-		std::swap_ranges(chrom1.begin(), chrom1.begin() + crossPoint,
-			chrom2.begin());
+		// first crossPoint moves come from the other parent
+		std::copy(chrom2.begin(), chrom2.begin() + crossPoint, child1.begin());
+		std::copy(chrom1.begin() + crossPoint, chrom1.end(), child1.begin() + crossPoint);
+		std::copy(chrom1.begin(), chrom1.begin() + crossPoint, child2.begin());
+		std::copy(chrom2.begin() + crossPoint, chrom2.end(), child2.begin() + crossPoint);
 	}
 }
 
-auto GAP::mutation(Population & next) -> void {
-	for (GeneticPlayer & gp : next.pop)
-	for (move_t & move : gp.strategy) {
-		if (!mutate(gen)) continue;
-
-		mutations++;
+template<size_t PopSize>
+auto GAP<PopSize>::mutation(Population & next) -> void {
+	// population strategies are treated as one flattened bitstream
+	CounterRng rng{ streams(generation, 0, RngOp::MUTATION) };
+	mutations += mutate.apply(popSize * chromLen, rng, [&](std::uint64_t pos) {
+		move_t & move{ next.pop[pos / chromLen].strategy[pos % chromLen] };
 		if (move == cooperate) move = deceive;
 		else move = cooperate;
-	}
+	});
 }
 
-auto GAP::debug() -> void {
+template<size_t PopSize>
+auto GAP<PopSize>::debug() -> void {
 	std::cerr << currPop() << "\n";
 }
 
-auto GAP::getRoundFormat(unsigned int index) -> std::string {
+template<size_t PopSize>
+auto GAP<PopSize>::getRoundFormat(unsigned int index) -> std::string {
 	std::stringstream ss;
 
 	std::string x{ std::bitset<6>(index).to_string() };
@@ -181,7 +520,8 @@ auto GAP::getRoundFormat(unsigned int index) -> std::string {
 	return ss.str();
 }
 
-auto GAP::exportPlayer(const GeneticPlayer& gp) -> void {
+template<size_t PopSize>
+auto GAP<PopSize>::exportPlayer(const GeneticPlayer& gp) -> void {
 	std::cerr << "Premoves: ";
 	for (size_t i = premoveIndex; i < chromLen; i+=2) 
 		std::cerr << "(" << moveSymbol(gp.strategy[i]) << "," << moveSymbol(gp.strategy[i + 1]) << ")";
@@ -195,7 +535,8 @@ auto GAP::exportPlayer(const GeneticPlayer& gp) -> void {
 	}
 }
 
-auto GAP::getBestPlayer(Population & pop) -> const GeneticPlayer& {
+template<size_t PopSize>
+auto GAP<PopSize>::getBestPlayer(Population & pop) -> const GeneticPlayer& {
 	fitness_t currMax{ std::numeric_limits<fitness_t>::min() };
 	size_t index{ 0 };
 	for (size_t i = 0; i < popSize; i++) {
@@ -207,9 +548,11 @@ auto GAP::getBestPlayer(Population & pop) -> const GeneticPlayer& {
 	return pop.pop[index];
 }
 
-GAP::GeneticPlayer::GeneticPlayer() : strategy(), fitness() {} 
+template<size_t PopSize>
+GAP<PopSize>::GeneticPlayer::GeneticPlayer() : strategy(), fitness() {} 
 
-auto GAP::GeneticPlayer::getPreMoves(std::vector<round_t>& preMoves) -> void {
+template<size_t PopSize>
+auto GAP<PopSize>::GeneticPlayer::getPreMoves(std::vector<round_t>& preMoves) -> void {
 	// index:		0		1		2		3		4		5	
 	//			(my3ago, him3ago)(my2ago, him2ago)(mylast, himlast)
 	// example: 101100 -> (I Cooperate, he Deceives)(I Cooperate, he Cooperates)(I Deceive, He Deceives)
@@ -218,17 +561,33 @@ auto GAP::GeneticPlayer::getPreMoves(std::vector<round_t>& preMoves) -> void {
 	preMoves.push_back(std::make_pair(strategy[68], strategy[69]));
 }
 
-GAP::Population::Population() : pop(), sum(), avg(), max(), min() {}
+template<size_t PopSize>
+GAP<PopSize>::Population::Population(size_t n) : pop(n), fitness(n), prefixSum(n), sum(), avg(), max(), min() {}
+
+template<size_t PopSize>
+auto GAP<PopSize>::Population::calcStats() -> void {
+	for (size_t i = 0; i < pop.size(); i++)
+		fitness[i] = pop[i].fitness;
+
+	FitnessSummary summary{ stats::summarize(fitness.data(), fitness.size()) };
+	sum = summary.sum;
+	avg = summary.avg;
+	max = summary.max;
+	min = summary.min;
+
+	std::partial_sum(fitness.begin(), fitness.end(), prefixSum.begin());
+}
+
+template<size_t PopSize>
+auto GAP<PopSize>::Population::write(std::ostream & file) const -> void {
+	const fitness_t stats[]{ sum, avg, max, min };
+	file.write(reinterpret_cast<const char *>(stats), sizeof(stats));
 
-auto GAP::Population::calcStats() -> void {
-	sum = 0;
-	max = min = pop[0].fitness;
 	for (const GeneticPlayer & gp : pop) {
-		sum += gp.fitness;
-		max = std::max(max, gp.fitness);
-		min = std::min(min, gp.fitness);
+		file.write(reinterpret_cast<const char *>(&gp.fitness), sizeof(gp.fitness));
+		file.write(reinterpret_cast<const char *>(gp.strategy.data()), sizeof(gp.strategy));
 	}
-	avg = sum / popSize;
 }
 
-
+template class gap::GAP<GAPConfig::fastPopSize>;
+template class gap::GAP<dynamicSize>;
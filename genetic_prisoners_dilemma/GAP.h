@@ -17,18 +17,83 @@
 #include <string>
 #include <sstream>
 #include <bitset>
+#include <numeric>
+#include <memory>
+#include "../common/GeometricMutation.h"
+#include "../common/PopulationBuffer.h"
+#include "../common/GenerationHistory.h"
+#include "../common/CounterRng.h"
+#include "../common/FitnessStats.h"
+#include "../common/Checkpoint.h"
+#include "../common/StopCriteria.h"
+#include "../common/RunTrace.h"
+#include "../common/ThreadPool.h"
+#include "GameKernel.h"
+#include "GameCache.h"
+#include "BitslicedGames.h"
 
 namespace gap {
+
+// how games are played, every mode gives the same game scores; fitness of
+// other modes matches SIMULATE up to rounding, which sums it in another order
+//	SIMULATE	- playGame, rounds kept in vectors (reference)
+//	KERNEL		- GameKernel.h, 6-bit history register, no allocation
+//	CYCLE		- kernel that stops at first repeated state and adds the
+//				  rest in closed form, cost does not depend on gameRounds
+//	BITSLICED	- BitslicedGames.h, tournament plays 64 (256 with AVX2)
+//				  games in lockstep, single games are played by KERNEL
+enum class GameMode {
+	SIMULATE, KERNEL, CYCLE, BITSLICED,
+};
+
+struct GAPConfig {
+	// population size of compile-time fast path GAP<fastPopSize>
+	static constexpr size_t fastPopSize{ 30 };
+
+	unsigned int seed{ 20u };
+	size_t popSize{ fastPopSize };		// even number
+	size_t gameRounds{ 150 };
+	double pMut{ 0.01 };
+	double pCross{ 0.25 };
+	GameMode game{ GameMode::CYCLE };
+	size_t threads{ 1 };				// tournament threads, 0 is hardware concurrency
+	size_t tileSize{ 128 };				// players per side of tournament tile
+	size_t gameCache{ 0 };				// games remembered across generations (LRU), 0 disables
+	HistoryConfig history;
+	CheckpointConfig checkpoint;
+	StopConfig stop;					// early stop, evaluations count games
+	TraceConfig trace;					// per-generation stats (and strategies) in background
+};
+
+struct GAPStats {
+	int generation{ 0 };
+	double sum{ 0.0 };
+	double avg{ 0.0 };
+	double max{ 0.0 };
+	double min{ 0.0 };
+	std::uint64_t games{ 0 };	// games played, initial tournament included
+	size_t distinct{ 0 };		// distinct strategies of current population, game cache only
+};
+
+// PopSize = dynamicSize keeps population on heap, sized by GAPConfig::popSize
+// fixed PopSize keeps it in place, GAP<GAPConfig::fastPopSize> is the only instantiated one
+// chromosome length is fixed by strategy encoding (64 answers + 3 premoves)
+template<size_t PopSize = dynamicSize>
 class GAP {
-	static constexpr size_t gameRounds{ 150 };
+	static_assert(PopSize == dynamicSize || PopSize % 2 == 0, "fixed population size has to be even");
+
 	static constexpr size_t chromLen{ 70 };
 	static constexpr size_t premoveIndex{ 64 };
-	static constexpr size_t popSize{ 30 };
-	static constexpr double pMut{ 0.01 };
-	static constexpr double pCross{ 0.25 };
-
-	const unsigned int seed{ 20u };
-	int mutations{ 0 };
+	const size_t popSize{ 30 };
+	const size_t gameRounds{ 150 };
+	const double pMut{ 0.01 };
+	const double pCross{ 0.25 };
+	const GameMode gameMode{ GameMode::CYCLE };
+
+	unsigned int seed{ 20u };
+	bool started{ false };	// tournament of initial population was played
+	int generation{ 0 };
+	std::uint64_t mutations{ 0 };
 	int crossings{ 0 };
 	
 	using move_t = bool;
@@ -54,23 +119,67 @@ class GAP {
 	};
 
 	struct Population {
-		std::array<GeneticPlayer, popSize> pop;
+		PopulationBuffer<GeneticPlayer, PopSize> pop;
+		PopulationBuffer<fitness_t, PopSize> fitness;	// contiguous copy of player fitness
+		PopulationBuffer<fitness_t, PopSize> prefixSum;	// filled by calcStats, for selection
 		fitness_t sum, avg;
 		fitness_t max, min;
 
+		// gathers player fitness, updates stats and prefix sums
 		auto calcStats() -> void;
-		Population();
+		Population(size_t n);
+
+		// binary dump: stats, then (fitness, strategy moves) of every player
+		auto write(std::ostream & file) const -> void;
 	};
 
-	std::vector<Population> populations;
+	// buffers[currIndex] holds current population, the other one is filled by next generation
+	std::vector<Population> buffers;
+	size_t currIndex{ 0 };
+	GenerationHistory<Population> history;
 
-	std::mt19937 gen;
+	// random streams keyed by (seed, generation, player, operator)
+	RngStreams streams;
 	std::uniform_real_distribution<fitness_t> fractDis;
 	std::uniform_int_distribution<size_t> crossPointDis{ 1, chromLen - 1 };
-	std::bernoulli_distribution mutate{ pMut };
+	GeometricMutation mutate{ pMut };
 	std::bernoulli_distribution cross{ pCross };
 
-	auto currPop() -> Population& { return populations.back(); }
+	std::vector<size_t> parents;	// selected players of current population, by child index
+	std::vector<PackedStrategy> packed;	// strategies of population being played, kernel modes
+
+	// kernel tournament: pair triangle split into tiles of tileSize x tileSize players,
+	// each worker sums whole game scores into its own row of accumulators
+	ThreadPool pool;
+	const size_t tileSize{ 128 };
+	std::vector<std::pair<size_t, size_t>> tiles;		// (first, second) block of players, first <= second
+	std::vector<std::vector<std::uint64_t>> scoreRows;	// scoreRows[worker][player]
+	std::vector<std::vector<GamePair>> tilePairs;		// BITSLICED: games of worker's tile
+	std::vector<std::vector<GameScore>> tileScores;		// and their scores
+
+	// cached tournament: every distinct strategy plays once per opponent strategy,
+	// scores are weighted by number of copies, games come from cache when they were played before
+	GameCache gameCache;
+	std::vector<size_t> order;					// players sorted by strategy
+	std::vector<PackedStrategy> distinct;		// distinct strategies of population
+	std::vector<std::uint64_t> copies;			// players of each distinct strategy
+	std::vector<std::uint32_t> distinctOf;		// distinct strategy of player
+	std::vector<std::uint64_t> distinctTotals;	// score of one player of each distinct strategy
+
+	CheckpointConfig checkpoint;
+	std::vector<char> checkpointBuf;
+	std::unique_ptr<CheckpointWriter> checkpointWriter;	// started by first checkpoint
+
+	StopCriteria stopping;
+	LocusCounter loci;
+
+	std::unique_ptr<TraceWriter> tracer;	// only when trace path is given
+
+	auto currPop() -> Population& { return buffers[currIndex]; }
+	auto nextPop() -> Population& { return buffers[currIndex ^ 1]; }
+
+	// config popSize, or the default one when tournament would have no opponents
+	static auto popSizeOf(const GAPConfig & config) -> size_t;
 
 	inline static auto moveSymbol(move_t move) -> char {
 		if (move == cooperate) return 'C';
@@ -91,11 +200,22 @@ class GAP {
 	// plays one game for every player, updates fitness sum
 	auto playGame(GeneticPlayer & p1, GeneticPlayer & p2) -> void;
 
+	// one game of packed strategies on kernel of configured mode
+	auto playPacked(const PackedStrategy & first, const PackedStrategy & second) const -> GameScore;
+
 	// play games among every player and sets their fitness scores
 	auto tournament(Population & pop) -> void;
 
-	auto selection(Population & next) -> void;
+	// plays every pair of given tile, adds scores to worker's accumulators
+	auto playTile(size_t tile, size_t worker) -> void;
+
+	// adds round robin scores to packed population through deduplication and game cache
+	auto cachedTournament(Population & pop) -> void;
+
+	// fills parents with indices of selected players in current population
+	auto selection() -> void;
 
+	// writes children of parent pairs from current population into next, each strategy once
 	auto crossing(Population & next) -> void;
 
 	auto mutation(Population & next) -> void;
@@ -106,12 +226,50 @@ class GAP {
 
 	auto debug() -> void;
 
+	// feeds current population to stop criteria, true when evolution should end
+	auto shouldStop() -> bool;
+
+	// games played so far, one round robin tournament per generation, initial population included
+	auto gamesPlayed() const -> std::uint64_t;
+
+	// appends stats (and strategies, one bit per move) of current population to trace
+	auto traceGeneration() -> void;
+
 public:
 	//auto evolveStrategy() -> void;
 
+	// strategy encoding of GeneticPlayer: answers to 64 histories of last 3 rounds, then premoves
+	using strategy_t = chromosome_t;
+	static constexpr size_t strategyLength{ chromLen };
+
+	// plays one game of configured length, returns scores of both strategies,
+	// touches no engine state, so it may be called from many threads
+	auto playMatch(const strategy_t & first, const strategy_t & second) -> std::pair<fitness_t, fitness_t>;
+
+	// evolves up to given generation (resumed run evolves only the rest), or until stop criteria fire
 	auto evolve(int generations = 50) -> void;
 
+	// evolves given number of generations without printing, fewer when stop criteria fire,
+	// first call plays tournament of initial population
+	auto step(int generations = 1) -> void;
+
+	auto stats() -> GAPStats;
+
+	// hits, misses and evictions of game cache since start
+	auto gameCacheStats() const -> GameCacheStats { return gameCache.stats(); }
+
+	// criterion that ended evolution, NONE while it runs to its generation count
+	auto stopReason() const -> StopReason { return stopping.reason(); }
+
+	// snapshot of current population, counters and seed, written in background to config path
+	auto saveCheckpoint() -> void;
+	auto saveCheckpoint(const std::string & path) -> void;
+
+	// restores state saved by saveCheckpoint, false (state untouched) when file is missing or does not match config
+	auto loadCheckpoint(const std::string & path) -> bool;
+
 	GAP(unsigned int seed = 20u);
+	GAP(const GAPConfig & config);
 
 	friend std::ostream& operator<<(std::ostream & stream, const GeneticPlayer& gp) {
 		stream << "Strategy: ";
@@ -0,0 +1,174 @@
+/* Game Cache
+*
+* Remembers scores of games already played, keyed by the pair of packed
+* strategies, so games between strategies that survive selection are not
+* replayed next generation. Game of (B, A) is game of (A, B) with scores
+* swapped, so both are stored once.
+*
+* Memory is bounded: capacity entries in one array, found through a
+* chained hash table, and kept in least recently used order. When full,
+* the least recently used game is evicted. Games have to depend only on
+* the strategies (fixed gameRounds). Not thread safe.
+*/
+
+#pragma once
+#include "GameKernel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gap {
+
+struct GameCacheStats {
+	std::uint64_t hits{ 0 };
+	std::uint64_t misses{ 0 };
+	std::uint64_t evictions{ 0 };
+	std::size_t size{ 0 };
+};
+
+class GameCache {
+	static constexpr std::uint32_t none{ std::numeric_limits<std::uint32_t>::max() };
+
+	struct Entry {
+		PackedStrategy first;
+		PackedStrategy second;
+		GameScore score;
+		std::uint32_t newer{ none };	// LRU neighbours
+		std::uint32_t older{ none };
+		std::uint32_t chain{ none };	// next entry of the same bucket
+	};
+
+	std::vector<Entry> entries;
+	std::vector<std::uint32_t> buckets;
+	std::uint64_t bucketMask{ 0 };
+	std::size_t capacity{ 0 };
+	std::uint32_t newest{ none };
+	std::uint32_t oldest{ none };
+	GameCacheStats counters;
+
+	static auto mix(std::uint64_t x) -> std::uint64_t {
+		// splitmix64 finalizer
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	static auto less(const PackedStrategy & a, const PackedStrategy & b) -> bool {
+		return a.answers < b.answers || (a.answers == b.answers && a.view < b.view);
+	}
+
+	static auto equal(const PackedStrategy & a, const PackedStrategy & b) -> bool {
+		return a.answers == b.answers && a.view == b.view;
+	}
+
+	auto bucketOf(const PackedStrategy & first, const PackedStrategy & second) const -> std::uint64_t {
+		std::uint64_t views{ static_cast<std::uint64_t>(first.view) << 6 | second.view };
+		return mix(first.answers ^ mix(second.answers ^ views)) & bucketMask;
+	}
+
+	auto unlink(std::uint32_t e) -> void {
+		Entry & entry{ entries[e] };
+		if (entry.newer != none) entries[entry.newer].older = entry.older;
+		else newest = entry.older;
+		if (entry.older != none) entries[entry.older].newer = entry.newer;
+		else oldest = entry.newer;
+		entry.newer = entry.older = none;
+	}
+
+	auto pushNewest(std::uint32_t e) -> void {
+		entries[e].older = newest;
+		entries[e].newer = none;
+		if (newest != none) entries[newest].newer = e;
+		newest = e;
+		if (oldest == none) oldest = e;
+	}
+
+	// removes oldest entry from its bucket chain and LRU list, returns its slot
+	auto evictOldest() -> std::uint32_t {
+		std::uint32_t e{ oldest };
+		std::uint32_t * link{ &buckets[bucketOf(entries[e].first, entries[e].second)] };
+		while (*link != e) link = &entries[*link].chain;
+		*link = entries[e].chain;
+		unlink(e);
+		counters.evictions++;
+		return e;
+	}
+
+public:
+	// capacity - games remembered, 0 disables cache (every lookup plays)
+	explicit GameCache(std::size_t capacity = 0) : capacity(capacity) {
+		if (capacity == 0) return;
+		std::size_t nBuckets{ 1 };
+		while (nBuckets < capacity) nBuckets <<= 1;
+		buckets.assign(nBuckets, none);
+		bucketMask = nBuckets - 1;
+		entries.reserve(capacity);
+	}
+
+	auto enabled() const -> bool { return capacity != 0; }
+
+	auto stats() const -> GameCacheStats {
+		GameCacheStats s{ counters };
+		s.size = entries.size();
+		return s;
+	}
+
+	// returns cached scores of (first, second), or stores and returns play(first, second)
+	template<typename Play>
+	auto get(const PackedStrategy & first, const PackedStrategy & second, Play && play) -> GameScore {
+		if (!enabled()) {
+			counters.misses++;
+			return play(first, second);
+		}
+
+		bool swapped{ less(second, first) };
+		const PackedStrategy & a{ swapped ? second : first };
+		const PackedStrategy & b{ swapped ? first : second };
+		auto mirror = [&](GameScore score) {
+			if (swapped) std::swap(score.first, score.second);
+			return score;
+		};
+
+		std::uint64_t bucket{ bucketOf(a, b) };
+		for (std::uint32_t e = buckets[bucket]; e != none; e = entries[e].chain) {
+			if (equal(entries[e].first, a) && equal(entries[e].second, b)) {
+				counters.hits++;
+				unlink(e);
+				pushNewest(e);
+				return mirror(entries[e].score);
+			}
+		}
+
+		counters.misses++;
+		GameScore score{ play(a, b) };
+
+		std::uint32_t e;
+		if (entries.size() < capacity) {
+			e = static_cast<std::uint32_t>(entries.size());
+			entries.emplace_back();
+		}
+		else e = evictOldest();
+
+		Entry & entry{ entries[e] };
+		entry.first = a;
+		entry.second = b;
+		entry.score = score;
+		entry.chain = buckets[bucket];
+		buckets[bucket] = e;
+		pushNewest(e);
+		return mirror(score);
+	}
+
+	auto clear() -> void {
+		entries.clear();
+		std::fill(buckets.begin(), buckets.end(), none);
+		newest = oldest = none;
+		counters = GameCacheStats{};
+	}
+};
+
+}
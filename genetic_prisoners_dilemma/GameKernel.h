@@ -0,0 +1,146 @@
+/* Game Kernel
+*
+* Prisoner's dilemma game of two GAP strategies without heap or round
+* vectors. Player's view of last 3 rounds is a 6-bit shift register,
+* laid out like GAP::getStrategyIndex:
+*
+*	bit 5, 4	- (mine, his) 3 rounds ago
+*	bit 3, 2	- (mine, his) 2 rounds ago
+*	bit 1, 0	- (mine, his) last round
+*
+* so a new round shifts the register by 2 and ORs in both moves, and the
+* move is bit view of 64-bit answer mask. Premoves of strategy are the
+* initial register. Scores are whole payoff units, same sums as playGame.
+*
+* Strategies are deterministic, and after 3 rounds the second view is the
+* first one with moves swapped, so the whole game is a walk over 64 states
+* of the first view. playCycle walks until a state repeats (at most 64
+* rounds) and adds the rest of the game in closed form, so its cost does
+* not depend on game length.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace gap {
+
+// GAP strategy compiled for kernels: answers[view] is the move (1 cooperate), view is initial register
+struct PackedStrategy {
+	std::uint64_t answers{ 0 };
+	std::uint32_t view{ 0 };
+};
+
+struct GameScore {
+	std::uint64_t first{ 0 };
+	std::uint64_t second{ 0 };
+};
+
+namespace kernel {
+
+constexpr std::size_t answerCount{ 64 };
+constexpr std::uint32_t viewMask{ 63 };
+constexpr std::size_t premoveRounds{ 3 };
+
+// payoff of the player whose view is (mine << 1 | his), 4 bits per outcome:
+// (D, D) 1, (D, C) 5, (C, D) 0, (C, C) 3
+constexpr std::uint32_t payoffTable{ 0x3051 };
+
+constexpr auto payoff(std::uint32_t outcome) -> std::uint32_t {
+	return (payoffTable >> (outcome * 4)) & 0xF;
+}
+
+// 64 answers, then premoves (mine, his) from 3 rounds ago to last one
+template<std::size_t N>
+auto pack(const std::array<bool, N> & strategy) -> PackedStrategy {
+	static_assert(N >= answerCount + 6, "strategy holds 64 answers and 6 premoves");
+	PackedStrategy packed;
+	for (std::size_t i = 0; i < answerCount; i++)
+		packed.answers |= static_cast<std::uint64_t>(strategy[i]) << i;
+	for (std::size_t i = 0; i < 6; i++)
+		packed.view |= static_cast<std::uint32_t>(strategy[answerCount + i]) << (5 - i);
+	return packed;
+}
+
+// plays rounds of game, both players decide from their own view of last 3 rounds
+inline auto play(const PackedStrategy & first, const PackedStrategy & second, std::size_t rounds) -> GameScore {
+	std::uint32_t a{ first.view };
+	std::uint32_t b{ second.view };
+	std::uint64_t scoreA{ 0 }, scoreB{ 0 };
+
+	for (std::size_t r = 0; r < rounds; r++) {
+		std::uint32_t moveA{ static_cast<std::uint32_t>(first.answers >> a) & 1u };
+		std::uint32_t moveB{ static_cast<std::uint32_t>(second.answers >> b) & 1u };
+		std::uint32_t outcomeA{ moveA << 1 | moveB };
+		std::uint32_t outcomeB{ moveB << 1 | moveA };
+
+		scoreA += payoff(outcomeA);
+		scoreB += payoff(outcomeB);
+		a = (a << 2 | outcomeA) & viewMask;
+		b = (b << 2 | outcomeB) & viewMask;
+	}
+	return { scoreA, scoreB };
+}
+
+// same scores as play, rounds after the first cycle are not simulated
+inline auto playCycle(const PackedStrategy & first, const PackedStrategy & second, std::size_t rounds) -> GameScore {
+	std::uint32_t a{ first.view };
+	std::uint32_t b{ second.view };
+	GameScore score;
+
+	// after opening premoves of both players are gone from views, b mirrors a
+	std::size_t opening{ rounds < premoveRounds ? rounds : premoveRounds };
+	for (std::size_t r = 0; r < opening; r++) {
+		std::uint32_t moveA{ static_cast<std::uint32_t>(first.answers >> a) & 1u };
+		std::uint32_t moveB{ static_cast<std::uint32_t>(second.answers >> b) & 1u };
+		std::uint32_t outcomeA{ moveA << 1 | moveB };
+		std::uint32_t outcomeB{ moveB << 1 | moveA };
+
+		score.first += payoff(outcomeA);
+		score.second += payoff(outcomeB);
+		a = (a << 2 | outcomeA) & viewMask;
+		b = (b << 2 | outcomeB) & viewMask;
+	}
+	if (rounds == opening) return score;
+
+	// seen[a] is walk step when view a was entered + 1, scores[t] are totals of first t steps
+	std::array<std::uint8_t, answerCount> seen{};
+	std::array<std::uint64_t, answerCount + 1> scoresA, scoresB;
+	scoresA[0] = scoresB[0] = 0;
+
+	std::size_t remaining{ rounds - opening };
+	std::size_t step{ 0 };
+	while (step < remaining && !seen[a]) {
+		seen[a] = static_cast<std::uint8_t>(step + 1);
+		std::uint32_t moveA{ static_cast<std::uint32_t>(first.answers >> a) & 1u };
+		std::uint32_t moveB{ static_cast<std::uint32_t>(second.answers >> b) & 1u };
+		std::uint32_t outcomeA{ moveA << 1 | moveB };
+		std::uint32_t outcomeB{ moveB << 1 | moveA };
+
+		scoresA[step + 1] = scoresA[step] + payoff(outcomeA);
+		scoresB[step + 1] = scoresB[step] + payoff(outcomeB);
+		a = (a << 2 | outcomeA) & viewMask;
+		b = (b << 2 | outcomeB) & viewMask;
+		step++;
+	}
+
+	score.first += scoresA[step];
+	score.second += scoresB[step];
+	if (step == remaining) return score;
+
+	// view a repeats: steps [start, step) loop forever
+	std::size_t start{ static_cast<std::size_t>(seen[a] - 1) };
+	std::size_t length{ step - start };
+	std::size_t left{ remaining - step };
+	std::uint64_t loops{ left / length };
+	std::size_t tail{ left % length };
+
+	score.first += loops * (scoresA[step] - scoresA[start]) + (scoresA[start + tail] - scoresA[start]);
+	score.second += loops * (scoresB[step] - scoresB[start]) + (scoresB[start + tail] - scoresB[start]);
+	return score;
+}
+
+}
+
+}
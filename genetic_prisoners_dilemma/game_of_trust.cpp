@@ -16,14 +16,32 @@
 #include <iostream>
 #include "GAP.h"
 
+// usage: game_of_trust [seed] [popSize] [gameRounds] [pMut] [pCross] [checkpoint] [interval] [stagnation] [trace] [traceGenomes] [threads] [gameCache]
+// run with checkpoint file continues from it when it exists
 int main(int argc, char ** argv) {
 	std::ios::sync_with_stdio(false);
 	
-	uint32_t seed = 20;
-	if ( argc > 1 ) {
-		seed = std::stoi(argv[1]);
-	}
+	gap::GAPConfig config;
+	if ( argc > 1 ) config.seed = std::stoi(argv[1]);
+	if ( argc > 2 ) config.popSize = std::stoul(argv[2]);
+	if ( argc > 3 ) config.gameRounds = std::stoul(argv[3]);
+	if ( argc > 4 ) config.pMut = std::stod(argv[4]);
+	if ( argc > 5 ) config.pCross = std::stod(argv[5]);
+	if ( argc > 6 ) config.checkpoint.path = argv[6];
+	if ( argc > 7 ) config.checkpoint.interval = std::stoi(argv[7]);
+	if ( argc > 8 ) config.stop.stagnationWindow = std::stoi(argv[8]);
+	if ( argc > 9 ) config.trace.path = argv[9];
+	if ( argc > 10 ) config.trace.genomes = std::stoi(argv[10]) != 0;
+	if ( argc > 11 ) config.threads = std::stoul(argv[11]);
+	if ( argc > 12 ) config.gameCache = std::stoul(argv[12]);
 	
-	gap::GAP GAPlayer(seed);
-	GAPlayer.evolve(50);
-}
+	// default population size runs on compile-time fast path
+	if (config.popSize == gap::GAPConfig::fastPopSize) {
+		gap::GAP<gap::GAPConfig::fastPopSize> GAPlayer(config);
+		GAPlayer.evolve(50);
+	}
+	else {
+		gap::GAP<> GAPlayer(config);
+		GAPlayer.evolve(50);
+	}
+}
\ No newline at end of file
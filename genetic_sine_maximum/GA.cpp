@@ -1,139 +1,504 @@
 #include "GA.h"
 
-GeneticAlgorithm::GeneticAlgorithm(unsigned int seed) :
-	seed(seed), populations(1), gen(seed), fractDis(0.0, 1.0), 
-	crossPointDis(1, chromLen-1) {
+template<std::size_t PopSize>
+GeneticAlgorithm<PopSize>::GeneticAlgorithm(unsigned int seed) :
+	GeneticAlgorithm([&] {
+		GAConfig config;
+		config.seed = seed;
+		return config;
+	}()) {}
 
-	std::bernoulli_distribution flip{ 0.5 };
+template<std::size_t PopSize>
+GeneticAlgorithm<PopSize>::GeneticAlgorithm(const GAConfig & config, GAObjective objective) :
+	variables(layoutOf(config)),
+	chromLen(std::accumulate(variables.begin(), variables.end(), 0, [](int sum, const GAVariable & v) { return sum + v.bits; })),
+	popSize(PopSize == dynamicSize ? config.popSize : static_cast<int>(PopSize)),
+	pCross(config.pCross), pMut(config.pMut), seed(config.seed),
+	// scalar path knows only the single sine variable
+	batchEval(config.batchEval || !config.variables.empty() || static_cast<bool>(objective)), 
+	buffers(2, Population(popSize, variables.size())), history(config.history),
+	cache(chromLen, batchEval ? CacheConfig{ CacheMode::NONE } : config.cache), genes(variables),
+	objective(objective ? std::move(objective) : GAObjective{ sineObjective }), parentBuf(popSize), checkpoint(config.checkpoint), stopping(config.stop),
+	streams(seed), fractDis(0.0, 1.0), crossPointDis(1, chromLen-1) {
 
-	// generate random population
-	for (Individual & ind : populations.back().population)
-		for (int i = 0; i < chromLen; i++) 
-			if (flip(gen)) ind.chrom.set(i);
-		
+	if (PopSize != dynamicSize && config.popSize != popSize)
+		std::cerr << "Config Error! popSize = " << config.popSize << " ignored, fixed size is " << popSize << '\n';
+
+	if (!config.trace.path.empty())
+		tracer = std::make_unique<TraceWriter>(config.trace, TraceEngine::GA, popSize, chromLen,
+			TraceGenomeOrder::HIGH_FIRST);
+
+	initPopulation();
+
+	if (!checkpoint.path.empty() && checkpoint.resume && std::filesystem::exists(checkpoint.path)) {
+		if (loadCheckpoint(checkpoint.path))
+			std::cerr << "Resumed from " << checkpoint.path << " at generation " << generation << '\n';
+		else
+			std::cerr << "Checkpoint Error! " << checkpoint.path << " does not match config, starting from generation 0\n";
+	}
 }
 
-auto GeneticAlgorithm::evolve(int generations) -> void {
-	populations.back().calcStats();
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::initPopulation() -> void {
+	// children are written into chromosomes of next population, so both buffers are allocated
+	for (Population & pop : buffers) {
+		for (Individual & ind : pop.population) {
+			if (ind.chrom.size() != static_cast<std::size_t>(chromLen)) ind.chrom = chromosome_t(chromLen);
+		}
+	}
 
-	for (int i = 1; i <= generations; i++) {
-		generation++;
-		Population newPop{};
-		evolvePopulation(newPop);
-		newPop.calcStats();
-		populations.push_back(newPop);	
+	// generate random population, chromosomes already allocated are reused
+	std::uint32_t index{ 0 };
+	for (Individual & ind : lastPop().population) {
+		CounterRng rng{ streams(0, index++, RngOp::INIT) };
+		ind.chrom.randomize(rng);
 	}
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::reseed(unsigned int newSeed) -> void {
+	seed = newSeed;
+	streams = RngStreams(seed);
+	started = false;
+	generation = 0;
+	mutations = 0;
+	crossings = 0;
+	evaluations = 0;
+	lastIndex = 0;
+	stopping.restart();
+	initPopulation();
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::evolve(int generations) -> void {
+	step(std::max(0, generations - generation));
 
 	//debug();
-	std::cout << "Evolved: " << generations << " generations.\n";
+	if (stopping.stopped())
+		std::cout << "Stopped at generation " << generation << ": " << toString(stopping.reason()) << '\n';
+	std::cout << "Evolved: " << (stopping.stopped() ? generation : generations) << " generations.\n";
 	std::cout << "Mutations:" << mutations << '\n';
 	std::cout << "Crossings:" << crossings << '\n';
-	std::cout << "Best Individual:{\n    " << populations.back().getBestIndividual() << "\n}\n";
+	std::cout << "Fitness cache hits:" << cache.hits() << " misses:" << cache.misses() << '\n';
+	if (variables.size() == 1) {
+		std::cout << "Best Individual:{\n    " << lastPop().getBestIndividual() << "\n}\n";
+		return;
+	}
+
+	// genotype of many variables is too long to print, show variables instead
+	const Individual & best{ lastPop().getBestIndividual() };
+	std::vector<fitness_t> row(genes.size());
+	genes.decode(best.chrom, row.data());
+	std::cout << "Best Individual:{\n    fitness:" << best.fitness << "\n    variables:";
+	for (std::size_t g = 0; g < row.size() && g < 10; g++) std::cout << ' ' << row[g];
+	if (row.size() > 10) std::cout << " ... (" << row.size() << " total)";
+	std::cout << "\n}\n";
+
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::step(int generations) -> void {
+	if (!started) {
+		evaluate(lastPop());
+		started = true;
+	}
+
+	for (int i = 1; i <= generations && !stopping.stopped(); i++) {
+		generation++;
+		Population & newPop{ nextPop() };
+		evolvePopulation(newPop);
+		evaluate(newPop);
+		history.record(generation, newPop);
+		if (tracer) traceGeneration(newPop);
+		lastIndex ^= 1;
+
+		// criteria first, so checkpoint carries their state of this generation
+		bool stop{ shouldStop() };
+		if (checkpointDue()) saveCheckpoint();
+		if (stop) break;
+	}
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::traceGeneration(const Population & pop) -> void {
+	tracer->add(TraceRow{ generation, evaluations, pop.max, pop.avg, pop.min });
+	if (!tracer->tracesGenomes()) return;
 
+	for (std::size_t i = 0; i < pop.population.size(); i++) {
+		const Individual & ind{ pop.population[i] };
+		tracer->fitness(i) = ind.fitness;
+		std::span<std::uint64_t> words{ tracer->genome(i) };
+		std::copy(ind.chrom.data(), ind.chrom.data() + words.size(), words.begin());
+	}
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::shouldStop() -> bool {
+	const Population & pop{ lastPop() };
+	double diversity{ 1.0 };
+	if (stopping.needsDiversity()) {
+		loci.reset(static_cast<std::size_t>(chromLen));
+		for (const Individual & ind : pop.population)
+			loci.addWords(ind.chrom.data(), ind.chrom.wordCount());
+		diversity = loci.diversity();
+	}
+	return stopping.update(generation, pop.max, evaluations, diversity);
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::checkpointDue() const -> bool {
+	return !checkpoint.path.empty() && checkpoint.interval > 0 && generation % checkpoint.interval == 0;
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::saveCheckpoint() -> void {
+	saveCheckpoint(checkpoint.path);
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::saveCheckpoint(const std::string & path) -> void {
+	step(0);
+	const Population & pop{ lastPop() };
+
+	CheckpointOut out{ checkpointBuf, CheckpointEngine::GA };
+	out.put(popSize);
+	out.put(chromLen);
+	out.put(seed);
+	out.put(generation);
+	out.put(mutations);
+	out.put(crossings);
+	out.put(evaluations);
+	out.put(stopping.state());
+
+	const fitness_t stats[]{ pop.sum, pop.avg, pop.max, pop.min };
+	out.put(stats, 4);
+	for (const Individual & ind : pop.population) {
+		out.put(ind.fitness);
+		out.put(ind.chrom.data(), ind.chrom.wordCount());
+	}
+	out.put(pop.prefixSum.data(), pop.prefixSum.size());
+
+	if (!checkpointWriter) checkpointWriter = std::make_unique<CheckpointWriter>();
+	checkpointWriter->submit(path, checkpointBuf);
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::loadCheckpoint(const std::string & path) -> bool {
+	CheckpointIn in{ path, CheckpointEngine::GA };
+	if (!in.expect(popSize) || !in.expect(chromLen)) return false;
+
+	unsigned int savedSeed{};
+	int savedGeneration{}, savedCrossings{};
+	std::uint64_t savedMutations{}, savedEvaluations{};
+	in.get(savedSeed);
+	in.get(savedGeneration);
+	in.get(savedMutations);
+	in.get(savedCrossings);
+	in.get(savedEvaluations);
+	StopState savedStop{};
+	in.get(savedStop);
+
+	// read into a copy, so a broken file leaves engine as it was
+	Population pop{ lastPop() };
+	fitness_t stats[4]{};
+	in.get(stats, 4);
+	pop.sum = stats[0];
+	pop.avg = stats[1];
+	pop.max = stats[2];
+	pop.min = stats[3];
+	for (std::size_t i = 0; i < pop.population.size(); i++) {
+		Individual & ind{ pop.population[i] };
+		in.get(ind.fitness);
+		in.get(ind.chrom.data(), ind.chrom.wordCount());
+		pop.fitness[i] = ind.fitness;
+	}
+	in.get(pop.prefixSum.data(), pop.prefixSum.size());
+	if (!in.complete()) return false;
+
+	lastPop() = std::move(pop);
+	seed = savedSeed;
+	streams = RngStreams(seed);
+	generation = savedGeneration;
+	mutations = savedMutations;
+	crossings = savedCrossings;
+	evaluations = savedEvaluations;
+	stopping.setState(savedStop);
+	started = true;
+	return true;
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::emigrate(std::size_t count, GAMigrant * out) -> void {
+	step(0);
+	Population & pop{ lastPop() };
+	count = std::min<std::size_t>(count, popSize);
+
+	// ties are broken by index, so order does not depend on sort implementation
+	rankBuf.resize(popSize);
+	std::iota(rankBuf.begin(), rankBuf.end(), std::size_t{ 0 });
+	std::partial_sort(rankBuf.begin(), rankBuf.begin() + count, rankBuf.end(), [&](std::size_t a, std::size_t b) {
+		if (pop.fitness[a] != pop.fitness[b]) return pop.fitness[a] > pop.fitness[b];
+		return a < b;
+	});
+
+	for (std::size_t k = 0; k < count; k++) {
+		// assignment reuses words of out[k], queue slots stop allocating after first migration
+		const Individual & ind{ pop.population[rankBuf[k]] };
+		out[k].chrom = ind.chrom;
+		out[k].genotype = decodeChrom(ind.chrom);
+		out[k].fitness = ind.fitness;
+	}
 }
 
-auto GeneticAlgorithm::debug() -> void {
-	std::cerr << "Generation: " << populations.size()-1 << "\n";
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::immigrate(const GAMigrant * in, std::size_t count) -> void {
+	step(0);
+	Population & pop{ lastPop() };
+	count = std::min<std::size_t>(count, popSize);
+
+	rankBuf.resize(popSize);
+	std::iota(rankBuf.begin(), rankBuf.end(), std::size_t{ 0 });
+	std::partial_sort(rankBuf.begin(), rankBuf.begin() + count, rankBuf.end(), [&](std::size_t a, std::size_t b) {
+		if (pop.fitness[a] != pop.fitness[b]) return pop.fitness[a] < pop.fitness[b];
+		return a < b;
+	});
+
+	for (std::size_t k = 0; k < count; k++) {
+		std::size_t i{ rankBuf[k] };
+		pop.population[i].chrom = in[k].chrom;
+		pop.fitness[i] = pop.population[i].fitness = in[k].fitness;
+	}
+	pop.calcStats();
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::stats() -> GAStats {
+	step(0);
+	Population & pop{ lastPop() };
+	const Individual & best{ pop.getBestIndividual() };
+	return GAStats{ generation, pop.sum, pop.avg, pop.max, pop.min, GAMigrant{ best.chrom, decodeChrom(best.chrom), best.fitness }, evaluations };
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::memoryPerIndividual() const -> std::size_t {
+	std::size_t words{ static_cast<std::size_t>(chromLen + PackedGenome::wordBits - 1) / PackedGenome::wordBits };
+	std::size_t perBuffer{ sizeof(Individual) + words * sizeof(PackedGenome::word_t)
+		+ 2 * sizeof(fitness_t) + variables.size() * sizeof(fitness_t) };
+	return buffers.size() * perBuffer;
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::debug() -> void {
+	std::cerr << "Generation: " << generation << "\n";
 	std::cerr << "Crossings: " << crossings << '\n';
 	std::cerr << "Mutations: " << mutations << '\n';
-	std::cerr << populations.back();
+	std::cerr << lastPop();
 }
 
-auto GeneticAlgorithm::decodeChrom(const chromosome_t & chrom) -> int {
-	return static_cast<int>(chrom.to_ulong());
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::decodeChrom(const chromosome_t & chrom) -> std::uint64_t {
+	return chrom.toUInt64();
 }
 
-auto GeneticAlgorithm::castChrom(const chromosome_t & chrom) -> fitness_t {
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::castChrom(const chromosome_t & chrom) -> fitness_t {
 	fitness_t bin_val{ static_cast<fitness_t>(decodeChrom(chrom)) };
-	fitness_t intervalBegin{ -1.0 };
-	fitness_t intervalEnd{ 2.0 };
-	fitness_t maxVal{ static_cast<fitness_t>(1 << chromLen) };
+	fitness_t maxVal{ std::ldexp(1.0, static_cast<int>(chrom.size())) };
 	fitness_t nIntervals{ intervalEnd - intervalBegin };
 
 	return intervalBegin + (bin_val*nIntervals) / maxVal;
 }
 
-auto GeneticAlgorithm::evalChrom(const chromosome_t & chrom) -> fitness_t {
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::evalChrom(const chromosome_t & chrom) -> fitness_t {
 	fitness_t x{ castChrom(chrom) };
 	return x * std::sin(10 * pi<fitness_t> * x) + 1.0;
 }
 
-auto GeneticAlgorithm::selection(const Population & last) -> const Individual& {
-	fitness_t choice{ fractDis(gen) * last.sum };
-	auto it = std::upper_bound(last.prefixSum.begin(), last.prefixSum.end(), choice);
-	return last.population[std::distance(last.prefixSum.begin(), it)];
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::sineObjective(std::span<const fitness_t> x, std::span<fitness_t> fitness) -> void {
+	std::size_t nVars{ fitness.empty() ? 1 : x.size() / fitness.size() };
+	std::fill(fitness.begin(), fitness.end(), 0.0);
+
+	// sines of one chunk go through vmath::sin together, rows may span chunks
+	constexpr std::size_t chunk{ 256 };
+	fitness_t sine[chunk];
+	std::size_t ind{ 0 }, var{ 0 };
+	for (std::size_t first = 0; first < x.size(); first += chunk) {
+		std::size_t n{ std::min(chunk, x.size() - first) };
+		for (std::size_t j = 0; j < n; j++)
+			sine[j] = 10 * pi<fitness_t> * x[first + j];
+
+		vmath::sin(sine, sine, n);
+
+		for (std::size_t j = 0; j < n; j++) {
+			fitness[ind] += x[first + j] * sine[j] + 1.0;
+			if (++var == nVars) {
+				var = 0;
+				ind++;
+			}
+		}
+	}
 }
 
-auto GeneticAlgorithm::crossing(Individual & p1, Individual & p2, size_t point) -> void {
-	chromosome_t ch1{ p1.chrom };
-	chromosome_t ch2 { p2.chrom};
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::layoutOf(const GAConfig & config) -> std::vector<GAVariable> {
+	// variables decode from one 64-bit field each, longer ones would decode to garbage
+	if (config.variables.empty()) {
+		if (config.chromLen >= 1 && config.chromLen <= 64)
+			return { GAVariable{ intervalBegin, intervalEnd, config.chromLen } };
+		std::cerr << "Config Error! chromLen = " << config.chromLen << " ignored, expected 1..64 bits, using " << GAConfig{}.chromLen << '\n';
+		return { GAVariable{ intervalBegin, intervalEnd, GAConfig{}.chromLen } };
+	}
 
-	// bitset counts from left [n, n-1, ... 0]
-	for (int i = chromLen-1; i >= chromLen-point; i--) {
-		if (p1.chrom.test(i)) ch2.set(i);
-		else ch2.reset(i);
+	std::vector<GAVariable> layout{ config.variables };
+	for (GAVariable & v : layout) {
+		if (!(v.begin < v.end))
+			std::cerr << "Config Error! variable [" << v.begin << ", " << v.end << ") expects begin < end\n";
+		if (v.bits < 1 || v.bits > 64) {
+			int bits{ std::clamp(v.bits, 1, 64) };
+			std::cerr << "Config Error! variable of " << v.bits << " bits ignored, expected 1..64 bits, using " << bits << '\n';
+			v.bits = bits;
+		}
+	}
+	return layout;
+}
 
-		if (p2.chrom.test(i)) ch1.set(i);
-		else ch1.reset(i);
+template<std::size_t PopSize>
+GeneticAlgorithm<PopSize>::GeneLayout::GeneLayout(const std::vector<GAVariable> & variables) {
+	std::size_t first{ 0 };
+	for (const GAVariable & v : variables) {
+		offset.push_back(first);
+		bits.push_back(static_cast<std::size_t>(v.bits));
+		begin.push_back(v.begin);
+		range.push_back(v.end - v.begin);
+		maxVal.push_back(std::ldexp(1.0, v.bits));
+		first += v.bits;
 	}
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::GeneLayout::decode(const chromosome_t & chrom, fitness_t * row) const -> void {
+	std::size_t n{ size() };
+	for (std::size_t g = 0; g < n; g++)
+		row[g] = static_cast<fitness_t>(chrom.field(offset[g], bits[g]));
 
-	p1.chrom = ch1;
-	p2.chrom = ch2;
+	// same operations as castChrom, so single variable is bit-identical to scalar path
+	for (std::size_t g = 0; g < n; g++)
+		row[g] = begin[g] + (row[g] * range[g]) / maxVal[g];
 }
 
-auto GeneticAlgorithm::mutation(Population & pop)-> void {
-	for (Individual & ind : pop.population) 
-	for (int i = 0; i < chromLen; i++) {
-		if (mutate(gen)) {
-			ind.chrom.flip(i);
-			mutations++;
-		}
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::evaluate(Population & pop) -> void {
+	if (batchEval) pop.decodePopBatch(genes, objective);
+	else pop.decodePop(cache);
+	pop.calcStats();
+	evaluations += pop.population.size();
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::selection(const Population & last, CounterRng & rng) -> std::size_t {
+	fitness_t choice{ fractDis(rng) * last.sum };
+	auto it = std::upper_bound(last.prefixSum.begin(), last.prefixSum.end(), choice);
+	// sum is added in other order than prefix sums, choice may land past the last one by rounding
+	std::size_t index{ static_cast<std::size_t>(std::distance(last.prefixSum.begin(), it)) };
+	return std::min(index, last.population.size() - 1);
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::selectParents(const Population & last) -> void {
+	for (int i = 0; i < popSize; i += 2) {
+		CounterRng selectRng{ streams(generation, i, RngOp::SELECTION) };
+		parentBuf[i] = selection(last, selectRng);
+		if (i + 1 < popSize) parentBuf[i + 1] = selection(last, selectRng);
 	}
 }
 
-auto GeneticAlgorithm::evolvePopulation(Population & pop) -> void{
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::crossing(const Individual & p1, const Individual & p2, Individual & c1, Individual & c2, size_t point) -> void {
+	// "point" most significant alleles come from the other parent
+	chromosome_t::swapRangeInto(p1.chrom, p2.chrom, c1.chrom, c2.chrom, 0, point);
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::mutation(Population & pop)-> void {
+	// population chromosomes are treated as one flattened bitstream
+	CounterRng rng{ streams(generation, 0, RngOp::MUTATION) };
+	mutations += mutate.apply(static_cast<std::uint64_t>(popSize) * chromLen, rng, [&](std::uint64_t pos) {
+		pop.population[pos / chromLen].chrom.flip(pos % chromLen);
+	});
+}
+
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::evolvePopulation(Population & pop) -> void{
+	const Population & last{ lastPop() };
+	selectParents(last);
+
 	for (int i = 0; i < popSize; i += 2) {
-		pop.population[i] = selection(populations.back());
-		pop.population[i+1] = selection(populations.back());
+		const Individual & p1{ last.population[parentBuf[i]] };
+
+		// odd population, last individual passes without crossing
+		if (i + 1 == popSize) {
+			pop.population[i].chrom = p1.chrom;
+			break;
+		}
+		const Individual & p2{ last.population[parentBuf[i + 1]] };
 
-		if (cross(gen)) {
-			size_t point{ crossPointDis(gen) };
-			crossing(pop.population[i], pop.population[i + 1], point);
+		CounterRng crossRng{ streams(generation, i, RngOp::CROSSING) };
+		if (cross(crossRng)) {
+			size_t point{ crossPointDis(crossRng) };
+			crossing(p1, p2, pop.population[i], pop.population[i + 1], point);
 			crossings++;
 		}
+		else {
+			pop.population[i].chrom = p1.chrom;
+			pop.population[i + 1].chrom = p2.chrom;
+		}
 	}
 	mutation(pop);
 }
 
-GeneticAlgorithm::Population::Population() : population(), prefixSum(),
+template<std::size_t PopSize>
+GeneticAlgorithm<PopSize>::Population::Population(std::size_t n, std::size_t nVars) : population(n), fitness(n), prefixSum(n), decoded(n * nVars),
 sum(), avg(), max(), min() {}
 
-auto GeneticAlgorithm::Population::calcStats() -> void{
-	decodePop();
-
-	fitness_t cSum{ 0.0 };
-	max = min = population.front().fitness;
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::Population::calcStats() -> void{
+	FitnessSummary summary{ stats::summarize(fitness.data(), fitness.size()) };
+	sum = summary.sum;
+	avg = summary.avg;
+	max = summary.max;
+	min = summary.min;
 
-	int index{ };
-	for (const Individual & ind : population) {
-		fitness_t curr{ ind.fitness };
-		cSum += curr;
+	std::partial_sum(fitness.begin(), fitness.end(), prefixSum.begin());
+}
 
-		prefixSum[index++] = cSum;
-		max = std::max(max, curr);
-		min = std::min(min, curr);
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::Population::decodePop(FitnessCache<fitness_t> & cache) -> void {
+	for (std::size_t i = 0; i < population.size(); i++) {
+		Individual & ind{ population[i] };
+		fitness[i] = ind.fitness = cache.get(decodeChrom(ind.chrom), [&] {
+			return GeneticAlgorithm::evalChrom(ind.chrom);
+		});
 	}
-	sum = cSum;
-	avg = cSum / popSize;
 }
 
-auto GeneticAlgorithm::Population::decodePop() -> void {
-	for (Individual & ind : population) {
-		ind.fitness = GeneticAlgorithm::evalChrom(ind.chrom);
-	}
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::Population::decodePopBatch(const GeneLayout & genes, const GAObjective & objective) -> void {
+	std::size_t n{ population.size() };
+	std::size_t nVars{ genes.size() };
+
+	for (std::size_t i = 0; i < n; i++)
+		genes.decode(population[i].chrom, decoded.data() + i * nVars);
+
+	objective(std::span<const fitness_t>(decoded.data(), n * nVars), std::span<fitness_t>(fitness.data(), n));
+
+	for (std::size_t i = 0; i < n; i++)
+		population[i].fitness = fitness[i];
 }
 
-auto GeneticAlgorithm::Population::getBestIndividual() -> const Individual& {
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::Population::getBestIndividual() -> const Individual& {
 	fitness_t currMax{ population[0].fitness };
 	int best{ 0 };
 	int index{ };
@@ -148,26 +513,19 @@ auto GeneticAlgorithm::Population::getBestIndividual() -> const Individual& {
 	return population[best];
 }
 
-auto operator<<(std::ostream & stream, const GeneticAlgorithm::Population & pop) -> std::ostream&{
-	stream << "Fitness Stats:   ";
-	stream << "sum: " << std::setw(7) << pop.sum;
-	stream << "    avg: " << std::setw(7) << pop.avg;
-	stream << "    max: " << std::setw(7) << pop.max;
-	stream << "    min: " << pop.min << "\n";
-	stream << "---------|\n";
-	for (int i = 0; i < pop.population.size(); i++) {
-		stream << "Ind#" << std::setw(3) << i << " -- " << pop.population[i] << '\n';
-		//stream << "PrefSum: " << pop.prefixSum[i] << '\n';
-	}
-	return stream;
-}
+template<std::size_t PopSize>
+GeneticAlgorithm<PopSize>::Individual::Individual() : chrom(), fitness() {}
 
-GeneticAlgorithm::Individual::Individual() : chrom(), fitness() {}
+template<std::size_t PopSize>
+auto GeneticAlgorithm<PopSize>::Population::write(std::ostream & file) const -> void {
+	const fitness_t stats[]{ sum, avg, max, min };
+	file.write(reinterpret_cast<const char *>(stats), sizeof(stats));
 
-auto operator<<(std::ostream & stream, const GeneticAlgorithm::Individual & ind) ->std::ostream& {
-	stream << "genotype:" << ind.chrom;
-	stream << "    decoded:" << std::setw(7) << GeneticAlgorithm::decodeChrom(ind.chrom);
-	stream << "    casted(-1,2):" << std::setw(7) << GeneticAlgorithm::castChrom(ind.chrom);
-	stream << "    fitness:" << std::setw(7) << ind.fitness;;
-	return stream;
+	for (const Individual & ind : population) {
+		file.write(reinterpret_cast<const char *>(&ind.fitness), sizeof(ind.fitness));
+		ind.chrom.write(file);
+	}
 }
+
+template class GeneticAlgorithm<GAConfig::fastPopSize>;
+template class GeneticAlgorithm<dynamicSize>;
@@ -8,24 +8,111 @@
 #include <iomanip>
 #include <memory>
 #include <algorithm> 
+#include <cmath>
+#include <numeric>
+#include <functional>
+#include <span>
+#include "../common/GeometricMutation.h"
+#include "../common/PackedGenome.h"
+#include "../common/PopulationBuffer.h"
+#include "../common/GenerationHistory.h"
+#include "../common/CounterRng.h"
+#include "../common/FitnessStats.h"
+#include "../common/FitnessCache.h"
+#include "../common/VectorMath.h"
+#include "../common/Checkpoint.h"
+#include "../common/StopCriteria.h"
+#include "../common/RunTrace.h"
 
 template<typename T>
 const T pi = std::acos(-T(1));
 
+// real variable encoded by bits consecutive alleles, cast to [begin, end)
+struct GAVariable {
+	double begin{ -1.0 };
+	double end{ 2.0 };
+	int bits{ 22 };
+};
+
+// evaluates whole population at once: x holds fitness.size() rows of
+// decoded variables (row-major, x.size() / fitness.size() per individual)
+using GAObjective = std::function<void(std::span<const double> x, std::span<double> fitness)>;
+
+struct GAConfig {
+	// population size of compile-time fast path GeneticAlgorithm<fastPopSize>
+	static constexpr std::size_t fastPopSize{ 50 };
+
+	unsigned int seed{ 20u };
+	int popSize{ static_cast<int>(fastPopSize) };	// even number
+	int chromLen{ 22 };								// 1..64 bits, at most 53 decode exactly
+	double pCross{ 0.25 };
+	double pMut{ 0.01 };
+	HistoryConfig history;
+	CheckpointConfig checkpoint;
+	StopConfig stop;								// early stop, evaluations count individuals
+	TraceConfig trace;								// per-generation stats (and genomes) in background
+	CacheConfig cache;								// fitness memo, keyed by chromosome value
+	bool batchEval{ false };						// whole population at once with vmath::sin, cache is not used
+	std::vector<GAVariable> variables;				// packed one after another, empty is one [-1, 2) variable of chromLen
+};
+
+// individual passed between GeneticAlgorithm instances (island model)
+struct GAMigrant {
+	PackedGenome chrom;				// whole chromosome, any length
+	std::uint64_t genotype{ 0 };	// chromosome value when chromLen <= 64, its lowest 64 bits otherwise
+	double fitness{ 0.0 };
+};
+
+struct GAStats {
+	int generation{ 0 };
+	double sum{ 0.0 };
+	double avg{ 0.0 };
+	double max{ 0.0 };
+	double min{ 0.0 };
+	GAMigrant best;
+	std::uint64_t evaluations{ 0 };	// individuals evaluated, initial population included
+};
+
+// PopSize = dynamicSize keeps population on heap, sized by GAConfig::popSize
+// fixed PopSize keeps it in place, GeneticAlgorithm<GAConfig::fastPopSize> is the only instantiated one
+template<std::size_t PopSize = dynamicSize>
 class GeneticAlgorithm {
+	static_assert(PopSize == dynamicSize || PopSize % 2 == 0, "fixed population size has to be even");
 
-	static constexpr int chromLen{ 22 };
-	static constexpr int popSize{ 50 };
-	static constexpr double pCross{ 0.25 };
-	static constexpr double pMut{ 0.01 };
-	const unsigned int seed{ 20 };
+	const std::vector<GAVariable> variables;
+	const int chromLen{ 22 };
+	const int popSize{ 50 };
+	const double pCross{ 0.25 };
+	const double pMut{ 0.01 };
+	unsigned int seed{ 20 };
+	const bool batchEval{ false };
+	bool started{ false };
 	int generation{ 0 };
-	int mutations{ 0 };
+	std::uint64_t mutations{ 0 };
 	int crossings{ 0 };
+	std::uint64_t evaluations{ 0 };
 
-	using chromosome_t = std::bitset<chromLen>; 
+	using chromosome_t = PackedGenome; 
 	using fitness_t = double;
 
+	static constexpr fitness_t intervalBegin{ -1.0 };
+	static constexpr fitness_t intervalEnd{ 2.0 };
+
+	// where every variable lives in chromosome, arrays indexed by variable
+	struct GeneLayout {
+		std::vector<std::size_t> offset;
+		std::vector<std::size_t> bits;
+		std::vector<fitness_t> begin;
+		std::vector<fitness_t> range;
+		std::vector<fitness_t> maxVal;
+
+		GeneLayout(const std::vector<GAVariable> & variables);
+		auto size() const -> std::size_t { return offset.size(); }
+
+		// writes every variable of chrom, cast to its interval, to row
+		auto decode(const chromosome_t & chrom, fitness_t * row) const -> void;
+	};
+
 	struct Individual {
 		chromosome_t chrom;
 		fitness_t fitness;
@@ -34,34 +121,62 @@ class GeneticAlgorithm {
 	};
 
 	struct Population {
-		std::array<Individual, popSize> population;
-		std::array<fitness_t, popSize> prefixSum;
+		PopulationBuffer<Individual, PopSize> population;
+		PopulationBuffer<fitness_t, PopSize> fitness;	// contiguous copy of individual fitness
+		PopulationBuffer<fitness_t, PopSize> prefixSum;
+		aligned_vector<fitness_t> decoded;				// n x nVars variables cast to intervals, batch path only
 		fitness_t sum;
 		fitness_t avg;
 		fitness_t max;
 		fitness_t min;
 
-		Population();
-		// calls decodePop(), and updates population stats
+		Population(std::size_t n, std::size_t nVars);
+		// updates population stats from fitness array
 		auto calcStats() -> void;
 
-		// uses eval function on every individual
-		auto decodePop() -> void;
+		// uses eval function on every individual, repeated genotypes are taken from cache
+		auto decodePop(FitnessCache<fitness_t> & cache) -> void;
+
+		// decodes all chromosomes to contiguous matrix, then evaluates it with objective
+		auto decodePopBatch(const GeneLayout & genes, const GAObjective & objective) -> void;
 
 		auto getBestIndividual() -> const Individual&;
+
+		// binary dump: stats, then (fitness, chromosome words) of every individual
+		auto write(std::ostream & file) const -> void;
 	};
 
-	// population.back() means last population
-	std::vector< Population > populations;
+	// buffers[lastIndex] holds last population, the other one is filled by next generation
+	std::vector< Population > buffers;
+	std::size_t lastIndex{ 0 };
+	GenerationHistory<Population> history;
+	FitnessCache<fitness_t> cache;
+	GeneLayout genes;
+	GAObjective objective;
+	std::vector<std::size_t> rankBuf;	// individual indices ordered by fitness, for migration
+	std::vector<std::size_t> parentBuf;	// selected parents in last population, by child index
+
+	CheckpointConfig checkpoint;
+	std::vector<char> checkpointBuf;
+	std::unique_ptr<CheckpointWriter> checkpointWriter;	// started by first checkpoint
+
+	StopCriteria stopping;
+	LocusCounter loci;
+
+	std::unique_ptr<TraceWriter> tracer;	// only when trace path is given
 
-	std::mt19937 gen;
+	auto lastPop() -> Population& { return buffers[lastIndex]; }
+	auto nextPop() -> Population& { return buffers[lastIndex ^ 1]; }
+
+	// random streams keyed by (seed, generation, individual, operator)
+	RngStreams streams;
 	std::uniform_real_distribution<double> fractDis;
 	std::uniform_int_distribution<size_t> crossPointDis;
-	std::bernoulli_distribution mutate{ pMut };
+	GeometricMutation mutate{ pMut };
 	std::bernoulli_distribution cross{ pCross };
 
 	// converts binary to int value
-	static auto decodeChrom(const chromosome_t & chrom) -> int;
+	static auto decodeChrom(const chromosome_t & chrom) -> std::uint64_t;
 
 	// casts chromosome value to range [-1, 2]
 	static auto castChrom(const chromosome_t & chrom)->fitness_t;
@@ -70,11 +185,23 @@ class GeneticAlgorithm {
 	// based on given fitness function
 	static auto evalChrom(const chromosome_t & chrom)->fitness_t;
 
-	// returns reference to chosen Individual in last population
-	auto selection(const Population & pop)->const Individual&; 
+	// default objective, sum of x sin(10 pi x) + 1 over variables of every row, vectorized
+	static auto sineObjective(std::span<const fitness_t> x, std::span<fitness_t> fitness) -> void;
+
+	// config variables, or the single [-1, 2) one of chromLen bits
+	static auto layoutOf(const GAConfig & config) -> std::vector<GAVariable>;
+
+	// evaluates population on configured path and updates its stats
+	auto evaluate(Population & pop) -> void;
+
+	// returns index of chosen Individual in last population
+	auto selection(const Population & pop, CounterRng & rng)->std::size_t; 
+
+	// fills parentBuf with indices of selected parents, pairs (2k, 2k + 1) are crossed
+	auto selectParents(const Population & last) -> void;
 
-	// takes population and crosses individuals with each other
-	auto crossing(Individual & p1, Individual & p2, size_t point)->void;
+	// writes children of p1 and p2 crossed at point, chromosomes are written once
+	auto crossing(const Individual & p1, const Individual & p2, Individual & c1, Individual & c2, size_t point)->void;
 
 	// takes chromosome and applies mutation
 	auto mutation(Population & pop)->void;
@@ -83,15 +210,76 @@ class GeneticAlgorithm {
 	// Selection, Crossing, Mutation
 	auto evolvePopulation(Population & pop) -> void;
 
+	// fills last population with random chromosomes of current seed
+	auto initPopulation() -> void;
+
+	// checkpoint interval passed with the last generation
+	auto checkpointDue() const -> bool;
+
+	// feeds last population to stop criteria, true when evolution should end
+	auto shouldStop() -> bool;
+
+	// appends stats (and genomes) of given generation to trace
+	auto traceGeneration(const Population & pop) -> void;
+
 	auto debug() -> void;
 
 public:
 	GeneticAlgorithm(unsigned int seed = 20u);
+	// objective replaces sine on batch path, it is used for every evaluation when given
+	GeneticAlgorithm(const GAConfig & config, GAObjective objective = {});
 
-	// Performs whole evolution of GA
+	// Performs whole evolution of GA, up to given generation (resumed run evolves only the rest)
 	auto evolve(int generations = 150) -> void;
 
-	friend std::ostream& operator<<(std::ostream & stream, const Individual & ind);
-	friend std::ostream& operator<<(std::ostream & stream, const Population & pop);
-};
+	// evolves given number of generations without printing, fewer when stop criteria fire,
+	// first call evaluates initial population
+	auto step(int generations = 1) -> void;
 
+	// writes count best individuals of last population to out, best first
+	auto emigrate(std::size_t count, GAMigrant * out) -> void;
+
+	// replaces count worst individuals of last population by migrants and updates stats
+	auto immigrate(const GAMigrant * in, std::size_t count) -> void;
+
+	auto stats() -> GAStats;
+
+	// criterion that ended evolution, NONE while it runs to its generation count
+	auto stopReason() const -> StopReason { return stopping.reason(); }
+
+	// starts again from generation 0 with new seed, population buffers and fitness cache are kept
+	auto reseed(unsigned int newSeed) -> void;
+
+	// snapshot of last population, counters and seed, written in background to config path
+	// (fitness cache and history are not part of it, cache hit counters start again)
+	auto saveCheckpoint() -> void;
+	auto saveCheckpoint(const std::string & path) -> void;
+
+	// restores state saved by saveCheckpoint, false (state untouched) when file is missing or does not match config
+	auto loadCheckpoint(const std::string & path) -> bool;
+
+	// bytes held per individual: both population buffers with chromosome words and decoded variables
+	auto memoryPerIndividual() const -> std::size_t;
+
+	friend std::ostream& operator<<(std::ostream & stream, const Individual & ind) {
+		stream << "genotype:" << ind.chrom;
+		stream << "    decoded:" << std::setw(7) << decodeChrom(ind.chrom);
+		stream << "    casted(-1,2):" << std::setw(7) << castChrom(ind.chrom);
+		stream << "    fitness:" << std::setw(7) << ind.fitness;;
+		return stream;
+	}
+
+	friend std::ostream& operator<<(std::ostream & stream, const Population & pop) {
+		stream << "Fitness Stats:   ";
+		stream << "sum: " << std::setw(7) << pop.sum;
+		stream << "    avg: " << std::setw(7) << pop.avg;
+		stream << "    max: " << std::setw(7) << pop.max;
+		stream << "    min: " << pop.min << "\n";
+		stream << "---------|\n";
+		for (std::size_t i = 0; i < pop.population.size(); i++) {
+			stream << "Ind#" << std::setw(3) << i << " -- " << pop.population[i] << '\n';
+			//stream << "PrefSum: " << pop.prefixSum[i] << '\n';
+		}
+		return stream;
+	}
+};
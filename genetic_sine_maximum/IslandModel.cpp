@@ -0,0 +1,117 @@
+#include "IslandModel.h"
+
+#include <thread>
+#include <numeric>
+
+IslandModel::IslandModel(const IslandConfig & config) :
+	nIslands(std::max<std::size_t>(config.islands, 1)), migrationInterval(std::max(config.migrationInterval, 1)),
+	nMigrants(std::min<std::size_t>(config.migrants, config.ga.popSize)), topology(config.topology),
+	seed(config.ga.seed), islands(), islandStats(nIslands), queues(nIslands * nIslands), pool(nIslands) {
+
+	// islands exchange migrants through queues, single island snapshot could not be resumed on its own
+	if (!config.ga.checkpoint.path.empty())
+		std::cerr << "Config Error! checkpoints are not supported by island model, " << config.ga.checkpoint.path << " ignored\n";
+
+	// island that stops alone would leave its neighbours waiting for migrants
+	if (config.ga.stop.enabled())
+		std::cerr << "Config Error! stop criteria are not supported by island model, ignored\n";
+
+	for (std::size_t i = 0; i < nIslands; i++) {
+		GAConfig islandConfig{ config.ga };
+		islandConfig.seed = config.ga.seed + static_cast<unsigned int>(i);
+		islandConfig.checkpoint.path.clear();
+		islandConfig.stop = StopConfig{};
+		// every island traces into its own file
+		if (!islandConfig.trace.path.empty()) islandConfig.trace.path.append(".").append(std::to_string(i));
+		islands.push_back(std::make_unique<Island>(islandConfig));
+		islandStats[i].ga = islands.back()->stats();
+	}
+
+	// producer may run ahead of consumer by at most nIslands epochs
+	std::size_t capacity{ nMigrants * (nIslands + 1) };
+	for (std::size_t from = 0; from < nIslands; from++) {
+		for (std::size_t to = 0; to < nIslands; to++) {
+			bool used{ topology == Topology::RING ? to == (from + 1) % nIslands : to != from };
+			if (used && from != to)
+				queues[from * nIslands + to] = std::make_unique<SpscQueue<GAMigrant>>(capacity);
+		}
+	}
+}
+
+auto IslandModel::permutation(int epoch, std::vector<std::size_t> & next) const -> void {
+	next.resize(nIslands);
+	std::iota(next.begin(), next.end(), std::size_t{ 0 });
+
+	if (topology == Topology::RING) {
+		for (std::size_t i = 0; i < nIslands; i++)
+			next[i] = (i + 1) % nIslands;
+		return;
+	}
+
+	// Sattolo's shuffle gives one cycle over all islands, so no island sends to itself
+	CounterRng rng{ seed, static_cast<std::uint32_t>(epoch), 0, RngOp::SELECTION };
+	for (std::size_t i = nIslands - 1; i > 0; i--) {
+		std::uniform_int_distribution<std::size_t> dis(0, i - 1);
+		std::swap(next[i], next[dis(rng)]);
+	}
+}
+
+auto IslandModel::queue(std::size_t from, std::size_t to) -> SpscQueue<GAMigrant>& {
+	return *queues[from * nIslands + to];
+}
+
+auto IslandModel::runIsland(std::size_t i, int firstGeneration, int generations) -> void {
+	Island & island{ *islands[i] };
+	IslandStats & stats{ islandStats[i] };
+
+	std::vector<std::size_t> next;
+	std::vector<GAMigrant> outgoing(nMigrants), incoming(nMigrants);
+
+	int generation{ firstGeneration };
+	int last{ firstGeneration + generations };
+	while (generation < last) {
+		int toBoundary{ migrationInterval - generation % migrationInterval };
+		int n{ std::min(toBoundary, last - generation) };
+		island.step(n);
+		generation += n;
+
+		if (generation % migrationInterval != 0 || nIslands == 1 || nMigrants == 0) continue;
+
+		int epoch{ generation / migrationInterval };
+		permutation(epoch, next);
+
+		std::size_t to{ next[i] };
+		std::size_t from{ static_cast<std::size_t>(std::find(next.begin(), next.end(), i) - next.begin()) };
+
+		island.emigrate(nMigrants, outgoing.data());
+		for (const GAMigrant & m : outgoing) {
+			while (!queue(i, to).tryPush(m)) std::this_thread::yield();
+		}
+		stats.sent += nMigrants;
+
+		for (GAMigrant & m : incoming) {
+			while (!queue(from, i).tryPop(m)) std::this_thread::yield();
+		}
+		island.immigrate(incoming.data(), nMigrants);
+		stats.received += nMigrants;
+	}
+
+	stats.ga = island.stats();
+}
+
+auto IslandModel::evolve(int generations) -> void {
+	// every island needs its own thread, they wait for each other at migrations
+	pool.parallelFor(nIslands, Schedule::STATIC, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t i = begin; i < end; i++)
+			runIsland(i, generation, generations);
+	});
+	generation += generations;
+}
+
+auto IslandModel::globalBest() const -> GAMigrant {
+	GAMigrant best{ islandStats.front().ga.best };
+	for (const IslandStats & s : islandStats) {
+		if (s.ga.best.fitness > best.fitness) best = s.ga.best;
+	}
+	return best;
+}
@@ -0,0 +1,95 @@
+/* Island Model
+*
+* K GeneticAlgorithm populations evolve on K threads. Every
+* migrationInterval generations each island sends its migrants best
+* individuals to one neighbour, which replace its worst ones.
+*
+*	RING	- island i sends to (i + 1) mod K
+*	RANDOM	- new random cyclic permutation every migration, same for all
+*			  islands (drawn from seed), so every island has one source
+*
+* Migrants carry whole chromosome, of any length. Every directed pair of
+* islands has its own lock-free SPSC queue. Island waits until migrants
+* of the same epoch arrive, so the result depends only on the seed, not
+* on thread timing.
+*/
+
+#pragma once
+#include "GA.h"
+#include "../common/SpscQueue.h"
+#include "../common/ThreadPool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+enum class Topology {
+	RING, RANDOM,
+};
+
+struct IslandConfig {
+	GAConfig ga;					// island i uses seed ga.seed + i, trace path + "." + i
+	std::size_t islands{ 4 };
+	int migrationInterval{ 10 };
+	std::size_t migrants{ 2 };
+	Topology topology{ Topology::RING };
+};
+
+struct IslandStats {
+	GAStats ga;
+	std::uint64_t sent{ 0 };
+	std::uint64_t received{ 0 };
+};
+
+class IslandModel {
+	using Island = GeneticAlgorithm<>;
+
+	const std::size_t nIslands;
+	const int migrationInterval;
+	const std::size_t nMigrants;
+	const Topology topology;
+	const std::uint64_t seed;
+
+	std::vector<std::unique_ptr<Island>> islands;
+	std::vector<IslandStats> islandStats;
+
+	// queues[from * nIslands + to], only pairs used by topology are allocated
+	std::vector<std::unique_ptr<SpscQueue<GAMigrant>>> queues;
+	ThreadPool pool;
+	int generation{ 0 };
+
+	// next[i] is island that i sends to in given epoch
+	auto permutation(int epoch, std::vector<std::size_t> & next) const -> void;
+	auto queue(std::size_t from, std::size_t to) -> SpscQueue<GAMigrant>&;
+
+	// evolves island from firstGeneration, migrating every migrationInterval generations
+	auto runIsland(std::size_t i, int firstGeneration, int generations) -> void;
+
+public:
+	IslandModel(const IslandConfig & config);
+
+	// evolves every island for given number of generations, may be called repeatedly
+	auto evolve(int generations) -> void;
+
+	auto size() const -> std::size_t { return nIslands; }
+	auto stats(std::size_t island) const -> const IslandStats& { return islandStats[island]; }
+	auto globalBest() const -> GAMigrant;
+
+	friend std::ostream& operator<<(std::ostream & stream, const IslandModel & model) {
+		for (std::size_t i = 0; i < model.nIslands; i++) {
+			const IslandStats & s{ model.islandStats[i] };
+			stream << "Island#" << std::setw(3) << i
+				<< "  gen: " << s.ga.generation
+				<< "  avg: " << std::setw(9) << s.ga.avg
+				<< "  max: " << std::setw(9) << s.ga.max
+				<< "  min: " << std::setw(9) << s.ga.min
+				<< "  sent: " << s.sent << "  received: " << s.received << '\n';
+		}
+		GAMigrant best{ model.globalBest() };
+		if (best.chrom.size() <= 64) stream << "Global best: decoded " << best.genotype;
+		else stream << "Global best: genotype " << best.chrom;
+		stream << "  fitness " << best.fitness << '\n';
+		return stream;
+	}
+};
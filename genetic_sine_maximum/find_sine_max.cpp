@@ -1,18 +1,115 @@
 ﻿#include "GA.h"
+#include "IslandModel.h"
+#include "../common/SeedSweep.h"
 #include <iostream>
+#include <string>
 
+// evolves given number of generations for every seed of sweep, or fewer when stop criteria fire
+auto seedSweep(const GAConfig & config, int generations, const SweepConfig & sweepConfig) -> void {
+	auto make = [&](std::size_t) { return std::make_unique<GeneticAlgorithm<>>(config); };
+	auto run = [&](GeneticAlgorithm<> & ga, unsigned int seed) {
+		ga.reseed(seed);
+		SweepRecord record{ seed };
+		ga.step(0);
+		record.best = ga.stats().max;
+		for (int gen = 1; gen <= generations && ga.stopReason() == StopReason::NONE; gen++) {
+			ga.step();
+			GAStats stats{ ga.stats() };
+			if (stats.max > record.best) {
+				record.best = stats.max;
+				record.bestGeneration = gen;
+			}
+			record.generations = stats.generation;
+			record.evaluations = stats.evaluations;
+		}
+		return record;
+	};
+
+	std::vector<SweepRecord> records{ sweep::run(sweepConfig, make, run) };
+	if (!sweepConfig.output.empty()) sweep::write(sweepConfig.output, records);
+	sweep::printQuantiles(std::cout, records);
+}
+
+// config arguments following seed, argv[first] is popSize
+auto readConfig(int argc, char ** argv, int first, GAConfig & config, std::size_t & islands) -> void {
+	auto has = [&](int k) { return argc > first + k; };
+	auto arg = [&](int k) { return std::string(argv[first + k]); };
+
+	if ( has(0) ) { config.popSize = std::stoi(arg(0)); }
+	if ( has(1) ) { config.chromLen = std::stoi(arg(1)); }
+	if ( has(2) ) { config.pMut = std::stod(arg(2)); }
+	if ( has(3) ) { config.pCross = std::stod(arg(3)); }
+	if ( has(4) ) { islands = std::stoul(arg(4)); }
+
+	// maximizes sum of f(x_i), every x_i c [-1, 2] encoded by chromLen bits
+	if ( has(5) ) { config.variables.assign(std::stoul(arg(5)), GAVariable{ -1.0, 2.0, config.chromLen }); }
+
+	// run with checkpoint file continues from it when it exists
+	if ( has(6) ) { config.checkpoint.path = arg(6); }
+	if ( has(7) ) { config.checkpoint.interval = std::stoi(arg(7)); }
+	// stops when best fitness did not improve for that many generations
+	if ( has(8) ) { config.stop.stagnationWindow = std::stoi(arg(8)); }
+	// binary trace of every generation, read by trace_dump
+	if ( has(9) ) { config.trace.path = arg(9); }
+	if ( has(10) ) { config.trace.genomes = std::stoi(arg(10)) != 0; }
+}
+
+// usage: find_sine_max [seed] [popSize] [chromLen] [pMut] [pCross] [islands] [variables] [checkpoint] [interval] [stagnation] [trace] [traceGenomes]
+//        find_sine_max sweep [firstSeed] [seeds] [output.csv|.bin] [threads] [generations] [popSize] ... [traceGenomes]
+//        (sweep takes the same arguments as single run after generations, seed excluded)
 int main(int argc, char ** argv) {
+	GAConfig config;
+	std::size_t islands{ 1 };
 	
-	uint32_t seed = 20u;
+	if ( argc > 1 && std::string(argv[1]) == "sweep" ) {
+		SweepConfig sweepConfig;
+		int generations{ 150 };
+		if ( argc > 2 ) { sweepConfig.firstSeed = std::stoi(argv[2]); }
+		if ( argc > 3 ) { sweepConfig.seeds = std::stoul(argv[3]); }
+		if ( argc > 4 ) { sweepConfig.output = argv[4]; }
+		if ( argc > 5 ) { sweepConfig.threads = std::stoul(argv[5]); }
+		if ( argc > 6 ) { generations = std::stoi(argv[6]); }
+		readConfig(argc, argv, 7, config, islands);
+
+		// every seed runs one population, in parallel with other seeds
+		if (islands > 1) { std::cerr << "Config Error! islands = " << islands << " ignored by sweep\n"; }
+		if (!config.checkpoint.path.empty()) {
+			std::cerr << "Config Error! checkpoints are not supported by sweep, " << config.checkpoint.path << " ignored\n";
+			config.checkpoint.path.clear();
+		}
+		if (!config.trace.path.empty()) {
+			std::cerr << "Config Error! traces are not supported by sweep, " << config.trace.path << " ignored\n";
+			config.trace.path.clear();
+		}
+		seedSweep(config, generations, sweepConfig);
+		return 0;
+	}
 	
-	if ( argc > 1 ) { seed = std::stoi(argv[1]); }
+	if ( argc > 1 ) { config.seed = std::stoi(argv[1]); }
+	readConfig(argc, argv, 2, config, islands);
 	
 	std::cout << "Genetic Algorithm for finding maximum of function: "
 		<< "f(x) = x sin( 10PIx) + 1,0 for all x c [-1, 2] \n";
 		
-	std::cout << "Starting with seed=" << seed << '\n';
+	std::cout << "Starting with seed=" << config.seed << '\n';
 
-	GeneticAlgorithm GA{ seed };
-	GA.evolve();
-}
+	// every island runs popSize individuals on its own thread
+	if (islands > 1) {
+		IslandConfig islandConfig;
+		islandConfig.ga = config;
+		islandConfig.islands = islands;
 
+		IslandModel model{ islandConfig };
+		model.evolve(150);
+		std::cout << model;
+	}
+	// default population size runs on compile-time fast path
+	else if (config.popSize == GAConfig::fastPopSize) {
+		GeneticAlgorithm<GAConfig::fastPopSize> GA{ config };
+		GA.evolve();
+	}
+	else {
+		GeneticAlgorithm<> GA{ config };
+		GA.evolve();
+	}
+}
@@ -1,29 +1,211 @@
 #include "SGA.h"
 
-SGA::SGA(unsigned int seed, int maxGen, SelectMethod selectM, ScalingType scaleType, std::function<fitness_t(fitness_t)> fitFunc) :
-	inputSeed(seed), maxGenerations(maxGen), selectMethod(selectM), scalingType(scaleType), 
-	fitnessFunction(fitFunc), lastPop(), currPop(), mutCnt(0), 
-	crossCnt(0), generations(), rd(), gen(( seed? seed : rd() )),
-	fractionDis(0, std::nextafter(1, std::numeric_limits<fitness_t>::max())),
-	crossPointDis(1, chromosomeLen-1), mutFlip(mutProb), crossFlip(crossProb)
+template<std::size_t PopSize>
+SGA<PopSize>::SGA(unsigned int seed, int maxGen, SelectMethod selectM, ScalingType scaleType, std::function<fitness_t(fitness_t)> fitFunc) :
+	SGA([&] {
+		SGAConfig config;
+		config.seed = seed;
+		config.maxGenerations = maxGen;
+		config.selectMethod = selectM;
+		config.scalingType = scaleType;
+		return config;
+	}(), fitFunc) {
+}
+
+template<std::size_t PopSize>
+SGA<PopSize>::SGA(const SGAConfig & config, std::function<fitness_t(fitness_t)> fitFunc) :
+	SGA(config, batch_fitness_t{ [fitFunc](std::span<const fitness_t> x, std::span<fitness_t> fitness) {
+		for (std::size_t i = 0; i < x.size(); i++)
+			fitness[i] = fitFunc(x[i]);
+	} }) {
+}
+
+template<std::size_t PopSize>
+SGA<PopSize>::SGA(const SGAConfig & config, batch_fitness_t batchFunc) :
+	popSize(PopSize == dynamicSize ? popSizeOf(config) : static_cast<int>(PopSize)),
+	mutProb(config.mutProb), crossProb(config.crossProb), inputSeed(config.seed), maxGenerations(config.maxGenerations), chromosomeLen(chromosomeLenOf(config)),
+	crossPoints(config.crossPoints), selectMethod(config.selectMethod), scalingType(config.scalingType),
+	crossingType(config.crossingType), fitnessFunction(std::move(batchFunc)), buffers(2, Population(popSize)), lastIndex(0), history(config.history), pool(config.threads),
+	schedule(config.schedule), grain(config.grain), mutCnt(0), 
+	crossCnt(0), generations(), streams(( inputSeed? inputSeed : std::random_device{}() )),
+	crossPointDis(1, chromosomeLen-1), crossPointBuf(crossPoints), mutation(mutProb), crossFlip(crossProb),
+	aliasTable(), weightBuf(popSize), fractionBuf(popSize), orderBuf(popSize), selectedBuf(popSize),
+	checkpoint(config.checkpoint), stopping(config.stop)
 {
+	if (PopSize != dynamicSize && config.popSize != popSize)
+		std::cerr << "Config Error! popSize = " << config.popSize << " ignored, fixed size is " << popSize << '\n';
+
+	if (!config.trace.path.empty())
+		tracer = std::make_unique<TraceWriter>(config.trace, TraceEngine::SGA, popSize, chromosomeLen,
+			TraceGenomeOrder::HIGH_FIRST);
+
+	initPopulation();
+
+	if (!checkpoint.path.empty() && checkpoint.resume && std::filesystem::exists(checkpoint.path)) {
+		if (loadCheckpoint(checkpoint.path))
+			std::cerr << "Resumed from " << checkpoint.path << " at generation " << generations << '\n';
+		else
+			std::cerr << "Checkpoint Error! " << checkpoint.path << " does not match config, starting from generation 0\n";
+	}
+}
+
+template<std::size_t PopSize>
+auto SGA<PopSize>::popSizeOf(const SGAConfig & config) -> int {
+	// parents are crossed in pairs
+	if (config.popSize >= 2) return config.popSize;
+	std::cerr << "Config Error! popSize = " << config.popSize << " ignored, expected at least 2, using " << SGAConfig{}.popSize << '\n';
+	return SGAConfig{}.popSize;
+}
+
+template<std::size_t PopSize>
+auto SGA<PopSize>::chromosomeLenOf(const SGAConfig & config) -> int {
+	// crossing point is drawn from [1, chromosomeLen - 1], fitness gets genotype decoded to double,
+	// which is inf from 1024 bits on
+	if (config.chromosomeLen >= 2 && config.chromosomeLen <= 1023) return config.chromosomeLen;
+	std::cerr << "Config Error! chromosomeLen = " << config.chromosomeLen << " ignored, expected 2..1023 bits, using " << SGAConfig{}.chromosomeLen << '\n';
+	return SGAConfig{}.chromosomeLen;
+}
+
+template<std::size_t PopSize>
+void SGA<PopSize>::initPopulation() {
 	// Generating random population
 	// Setting it as "lastPop" 
 
-	std::bernoulli_distribution bitFlip(0.5);
 	int id{ };
-	for (Individual & ind : lastPop.population) {
+	for (Individual & ind : lastPop().population) {
+		CounterRng rng{ streams(0, id, RngOp::INIT) };
+		if (ind.genotype.size() != static_cast<std::size_t>(chromosomeLen))
+			ind = Individual{ chromosome_t(chromosomeLen) };
 		ind.id = id++;
-		for (allele_t & al : ind.genotype)
-			al = bitFlip(gen);
+		ind.genotype.randomize(rng);
 	}
 
-	calculatePopulation(lastPop);
+	currPop() = lastPop();
+	calculatePopulation(lastPop());
+	lastPop().updateIndividuals();
 }
 
-SGA::~SGA() { }
+template<std::size_t PopSize>
+auto SGA<PopSize>::traceGeneration(const Population & pop) -> void {
+	std::uint64_t evaluations{ static_cast<std::uint64_t>(popSize) * (generations + 1) };
+	tracer->add(TraceRow{ generations, evaluations, pop.maxFitness, pop.avgFitness, pop.minFitness });
+	if (!tracer->tracesGenomes()) return;
+
+	// individual fitness is written back only after scaling, evaluated holds raw one
+	for (std::size_t i = 0; i < pop.population.size(); i++) {
+		tracer->fitness(i) = pop.evaluated[i];
+		std::span<std::uint64_t> words{ tracer->genome(i) };
+		const chromosome_t & genotype{ pop.population[i].genotype };
+		std::copy(genotype.data(), genotype.data() + words.size(), words.begin());
+	}
+}
 
-void SGA::debug(std::ostream & file,  Population & pop) {
+template<std::size_t PopSize>
+auto SGA<PopSize>::shouldStop(const Population & pop) -> bool {
+	double diversity{ 1.0 };
+	if (stopping.needsDiversity()) {
+		loci.reset(chromosomeLen);
+		for (const Individual & ind : pop.population)
+			loci.addWords(ind.genotype.data(), ind.genotype.wordCount());
+		diversity = loci.diversity();
+	}
+	return stopping.update(generations, pop.maxFitness, static_cast<std::uint64_t>(popSize) * (generations + 1), diversity);
+}
+
+template<std::size_t PopSize>
+void SGA<PopSize>::saveCheckpoint() {
+	saveCheckpoint(checkpoint.path);
+}
+
+template<std::size_t PopSize>
+void SGA<PopSize>::saveCheckpoint(const std::string & path) {
+	const Population & pop{ lastPop() };
+
+	CheckpointOut out{ checkpointBuf, CheckpointEngine::SGA };
+	out.put(popSize);
+	out.put(chromosomeLen);
+	out.put(streams.getSeed());
+	out.put(generations);
+	out.put(mutCnt);
+	out.put(crossCnt);
+	out.put(stopping.state());
+
+	const fitness_t stats[]{ pop.sumFitness, pop.avgFitness, pop.maxFitness, pop.minFitness, pop.rawMaxFitness };
+	out.put(stats, 5);
+	for (const Individual & ind : pop.population) {
+		out.put(ind.fitness);
+		out.put(ind.expectedCopies);
+		out.put(ind.id);
+		out.put(ind.genotype.data(), ind.genotype.wordCount());
+	}
+	out.put(pop.decoded.data(), pop.decoded.size());
+	out.put(pop.evaluated.data(), pop.evaluated.size());
+
+	if (!checkpointWriter) checkpointWriter = std::make_unique<CheckpointWriter>();
+	checkpointWriter->submit(path, checkpointBuf);
+}
+
+template<std::size_t PopSize>
+auto SGA<PopSize>::loadCheckpoint(const std::string & path) -> bool {
+	CheckpointIn in{ path, CheckpointEngine::SGA };
+	if (!in.expect(popSize) || !in.expect(chromosomeLen)) return false;
+
+	std::uint64_t savedSeed{};
+	int savedGenerations{}, savedCrossings{};
+	std::uint64_t savedMutations{};
+	in.get(savedSeed);
+	in.get(savedGenerations);
+	in.get(savedMutations);
+	in.get(savedCrossings);
+	StopState savedStop{};
+	in.get(savedStop);
+
+	// read into a copy, so a broken file leaves engine as it was
+	Population pop{ lastPop() };
+	fitness_t stats[5]{};
+	in.get(stats, 5);
+	pop.sumFitness = stats[0];
+	pop.avgFitness = stats[1];
+	pop.maxFitness = stats[2];
+	pop.minFitness = stats[3];
+	pop.rawMaxFitness = stats[4];
+	for (Individual & ind : pop.population) {
+		in.get(ind.fitness);
+		in.get(ind.expectedCopies);
+		in.get(ind.id);
+		in.get(ind.genotype.data(), ind.genotype.wordCount());
+	}
+	in.get(pop.decoded.data(), pop.decoded.size());
+	in.get(pop.evaluated.data(), pop.evaluated.size());
+	if (!in.complete()) return false;
+
+	lastPop() = std::move(pop);
+	inputSeed = static_cast<unsigned int>(savedSeed);
+	streams = RngStreams(savedSeed);
+	generations = savedGenerations;
+	mutCnt = savedMutations;
+	crossCnt = savedCrossings;
+	stopping.setState(savedStop);
+	return true;
+}
+
+template<std::size_t PopSize>
+void SGA<PopSize>::reseed(unsigned int seed) {
+	inputSeed = seed ? seed : std::random_device{}();
+	streams = RngStreams(inputSeed);
+	mutCnt = 0;
+	crossCnt = 0;
+	generations = 0;
+	lastIndex = 0;
+	stopping.restart();
+	initPopulation();
+}
+
+template<std::size_t PopSize>
+SGA<PopSize>::~SGA() { }
+
+template<std::size_t PopSize>
+void SGA<PopSize>::debug(std::ostream & file,  Population & pop) {
 
 	file << "Generation #" << generations << '\n';
 	file << "Stats: {\n";
@@ -43,296 +225,281 @@ void SGA::debug(std::ostream & file,  Population & pop) {
 	file << "|-----------------------\n\n";
 }
 
-void SGA::scalePopulation(Population & pop) {
+template<std::size_t PopSize>
+void SGA<PopSize>::scalePopulation(Population & pop) {
 
 	switch (this->scalingType) {
-	case ScalingType::NONE: pop.scaleNone(); break;
+	case ScalingType::NONE: break;
 	case ScalingType::LINEAR: pop.scaleLinear(); break;
 	default: std::cerr << "Scaling Error! Unknown Scaling Type\n";
 	}
-
-	pop.calculateStatistics();
-	pop.updateIndividuals();
-	pop.resetIDs();
 }
 
-void SGA::evolvePopulation(Population & last, Population & curr) {
+template<std::size_t PopSize>
+void SGA<PopSize>::evolvePopulation(Population & last, Population & curr) {
 	generations++;
 
 	// Gets last population, and based on choosen selection method 
-	// fills current population genotypes 
-	selectPopulation(last, curr);	
+	// picks indices of parents
+	selectPopulation(last);	
 
 	// Chooses crossing, based on crossing type
-	// Cross adjecent individuals in current population
-	crossPopulation(curr);				
+	// Crosses adjecent parents, children are written into current population
+	crossPopulation(last, curr);				
 
 	// Iterates over alleles of individuals in population, applying mutations
 	mutatePopulation(curr);
 
 	// decodes new population (calc individual fitness, based on fitness function)
 	// calculates stats (sum, avg, min, max)
-	// resets population IDs
-	// calculates other individuals stats (expected Copies)
 	calculatePopulation(curr);	
+	if (tracer) traceGeneration(curr);
 
-
-	// dont scale if last generation
-	if (generations != maxGenerations) 
+	// dont scale if last generation, stop criteria see unscaled fitness
+	bool stop{ shouldStop(curr) };
+	if (generations != maxGenerations && !stop) 
 	{
 		// scale population based on scalingType
 		scalePopulation(curr);
 	}
 
-	//debug(std::cerr, curr);			// debug
-	last = curr;						// change generations
-}
+	// sets individual fitness, expected copies and resets population IDs
+	curr.updateIndividuals();
 
-void SGA::crossPopulation(Population & curr) {
-	for (int i = 0; i < popSize; i += 2) {
+	//debug(std::cerr, curr);			// debug
+	history.record(generations, curr);
+	lastIndex ^= 1;						// change generations, curr becomes last
 
-		std::pair<Individual, Individual> childsPair{ 
-			simpleCrossing(curr.population[i], curr.population[i+1]) 
-		};
+	if (!checkpoint.path.empty() && checkpoint.interval > 0 && generations % checkpoint.interval == 0)
+		saveCheckpoint();
+}
 
-		curr.population[i] = childsPair.first;
-		curr.population[i+1] = childsPair.second;
+template<std::size_t PopSize>
+void SGA<PopSize>::crossPopulation(const Population & last, Population & curr) {
+	for (int i = 0; i + 1 < popSize; i += 2) {
+		CounterRng rng{ streams(generations, i, RngOp::CROSSING) };
+		crossing(last.population[selectedBuf[i]], last.population[selectedBuf[i + 1]],
+			curr.population[i], curr.population[i + 1], rng);
 	}
+
+	// odd population, last parent passes without crossing
+	if (popSize % 2)
+		curr.population[popSize - 1].genotype = last.population[selectedBuf[popSize - 1]].genotype;
 }
 
-void SGA::calculatePopulation(Population & pop) {
-	pop.decodeIndividuals(fitnessFunction);
+template<std::size_t PopSize>
+void SGA<PopSize>::calculatePopulation(Population & pop) {
+	pop.decodeIndividuals(fitnessFunction, pool, schedule, grain);
 	pop.calculateStatistics();
-	pop.updateIndividuals();
-	pop.resetIDs();
+	pop.rawMaxFitness = pop.maxFitness;
 }
 
-void SGA::selectPopulation(Population & last, Population & curr) {
+template<std::size_t PopSize>
+void SGA<PopSize>::selectPopulation(const Population & last) {
 
 	switch (this->selectMethod) {
-	case SelectMethod::ROULETTE: rouletteSelection(last, curr); break;
-	case SelectMethod::DETERMINISTIC: deterministicSelection(last, curr); break;
-	case SelectMethod::TRUNCATION: truncationSelection(last, curr); break;
+	case SelectMethod::ROULETTE: rouletteSelection(last); break;
+	case SelectMethod::DETERMINISTIC: deterministicSelection(last); break;
+	case SelectMethod::TRUNCATION: truncationSelection(last); break;
+	case SelectMethod::SUS: universalSelection(last); break;
 	default: std::cerr << "Selecting Error! Unknown selecting type\n";
 	}
-
 }
 
-void SGA::rouletteSelection(const Population & last, Population & curr) {
-	for (Individual & ind : curr.population) {
-
-		fitness_t partialSum{ };
-		fitness_t randSum{ SGA::getRandomFraction() * last.sumFitness };
+template<std::size_t PopSize>
+void SGA<PopSize>::rouletteSelection(const Population & last) {
+	for (int i = 0; i < popSize; i++)
+		weightBuf[i] = last.population[i].fitness;
 
-		auto it{ last.population.begin() };
+	aliasTable.build(weightBuf.data(), popSize);
 
-		while (partialSum <= randSum) {
-			partialSum += it->fitness;
-			it++;
+	// every child draws from its own stream, so sampling can be split among threads
+	pool.parallelFor(popSize, schedule, grain, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t k = begin; k < end; k++) {
+			CounterRng rng{ streams(generations, k, RngOp::SELECTION) };
+			selectedBuf[k] = aliasTable.sample(rng);
 		}
-		ind = *(--it);
-	}
+	});
 }
 
-void SGA::deterministicSelection(const Population & last, Population & curr) {
-
-	std::array<fitness_t, popSize> fractionPart{ };
-	std::array<int, popSize> selectPerm{ };
-
-	std::iota(selectPerm.begin(), selectPerm.end(), 0);
+template<std::size_t PopSize>
+void SGA<PopSize>::deterministicSelection(const Population & last) {
 
 	int nextID{ };
-	int spaceLeft{ popSize };
 
 	for (const Individual & ind : last.population) {
 		int sureCopies{ static_cast<int>( ind.expectedCopies) };
 
-		fractionPart[ind.id] = ind.expectedCopies - static_cast<fitness_t>(sureCopies);
+		fractionBuf[ind.id] = ind.expectedCopies - static_cast<fitness_t>(sureCopies);
 
 		// Copy sure amount of individuals into next gen
-		while (sureCopies--) {
-			curr.population[nextID++] = ind;
-			spaceLeft--;
-		}
+		while (sureCopies-- && nextID < popSize)
+			selectedBuf[nextID++] = ind.id;
 	}
 
 	// sort Individuals (ids) accordingly to their expected copies fractions 
-	std::sort(selectPerm.begin(), selectPerm.end(), [&](int a, int b) {
-		return fractionPart[a] > fractionPart[b];
+	std::iota(orderBuf.begin(), orderBuf.end(), 0);
+	std::sort(orderBuf.begin(), orderBuf.end(), [&](std::size_t a, std::size_t b) {
+		return fractionBuf[a] > fractionBuf[b];
 	});
 
 	// Based on sorted order, copy individuals
-	for (int i = 0; spaceLeft && i < popSize; i++) {
-		curr.population[nextID++] = last.population[selectPerm[i]];
-		spaceLeft--;
-	}
+	for (int i = 0; nextID < popSize; i++)
+		selectedBuf[nextID++] = orderBuf[i];
 }
 
-void SGA::truncationSelection(const Population & last, Population & curr) {
+template<std::size_t PopSize>
+void SGA<PopSize>::truncationSelection(const Population & last) {
+	for (int i = 0; i < popSize; i++)
+		weightBuf[i] = last.population[i].expectedCopies;
 
-	std::array<fitness_t, popSize> fractionPart{ };
-	std::array<int, popSize> selectPerm{ };
+	// at most one Bernoulli trial per individual, slots left are filled with one SUS spin
+	CounterRng rng{ streams(generations, 0, RngOp::SELECTION) };
+	selection::remainderStochastic(weightBuf.data(), popSize, popSize, rng,
+		selectedBuf.data(), fractionBuf, orderBuf);
+}
 
-	std::iota(selectPerm.begin(), selectPerm.end(), 0);
+template<std::size_t PopSize>
+void SGA<PopSize>::universalSelection(const Population & last) {
+	for (int i = 0; i < popSize; i++)
+		weightBuf[i] = last.population[i].fitness;
 
-	int nextID{ };
-	int spaceLeft{ popSize };
+	CounterRng rng{ streams(generations, 0, RngOp::SELECTION) };
+	selection::stochasticUniversal(weightBuf.data(), popSize, popSize, rng, selectedBuf.data());
 
-	for (const Individual & ind : last.population) {
-		int sureCopies{ static_cast<int>(ind.expectedCopies) };
+	// pointers come out in population order, shuffle so that crossing pairs are random
+	std::shuffle(selectedBuf.begin(), selectedBuf.end(), rng);
+}
 
-		fractionPart[ind.id] = ind.expectedCopies - static_cast<fitness_t>(sureCopies);
+template<std::size_t PopSize>
+void SGA<PopSize>::crossing(const Individual & parent1, const Individual & parent2,
+	Individual & child1, Individual & child2, CounterRng & rng) {
 
-		// Copy sure amount of individuals into next gen
-		while (sureCopies--) {
-			curr.population[nextID++] = ind;
-			spaceLeft--;
-		}
+	// if not flipped crossing, parents pass unchanged
+	if (!crossFlip(rng)) {
+		child1.genotype = parent1.genotype;
+		child2.genotype = parent2.genotype;
+		return;
 	}
 
-	// sort Individuals (ids) accordingly to their expected copies fractions 
-	std::sort(selectPerm.begin(), selectPerm.end(), [&](int a, int b) {
-		return fractionPart[a] > fractionPart[b];
-	});
-
-	// Based on sorted order, try bernoully's distribution
-	// untill you fill whole population
-	for (int i = 0; spaceLeft; i++) {
-		int t{ selectPerm[i%popSize] };  // sorted order;
+	// Increase counter
+	crossCnt++;
 
-		std::bernoulli_distribution copyFlip(fractionPart[t]);
-		if (copyFlip(gen)) {
-			curr.population[nextID++] = last.population[t];
-			spaceLeft--;
-		}
+	// children words are written once, from masked words of parents genotypes
+	const chromosome_t & g1{ parent1.genotype };
+	const chromosome_t & g2{ parent2.genotype };
+	switch (this->crossingType) {
+	case CrossingType::SINGLE_POINT:
+		chromosome_t::swapRangeInto(g1, g2, child1.genotype, child2.genotype, 0, crossPointDis(rng));
+		break;
+	case CrossingType::MULTI_POINT:
+		for (std::size_t & point : crossPointBuf)
+			point = crossPointDis(rng);
+		std::sort(crossPointBuf.begin(), crossPointBuf.end());
+		chromosome_t::multiPointCrossInto(g1, g2, child1.genotype, child2.genotype, crossPointBuf);
+		break;
+	case CrossingType::UNIFORM:
+		chromosome_t::uniformCrossInto(g1, g2, child1.genotype, child2.genotype, rng);
+		break;
+	default: std::cerr << "Crossing Error! Unknown crossing type\n";
 	}
 }
 
-std::pair<SGA::Individual, SGA::Individual> 
-	SGA::simpleCrossing(const Individual & parent1, const Individual & parent2) {
+template<std::size_t PopSize>
+void SGA<PopSize>::mutatePopulation(Population & pop) {
 
-	// if not flipped crossing, just return selected parents
-	if (!crossFlip(gen))	
-		return std::make_pair(parent1, parent2);
-	
-	// select crossing points
-	int cp{ crossPointDis(gen) };
+	// population genotypes are treated as one flattened bitstream
+	std::uint64_t nBits{ static_cast<std::uint64_t>(popSize) * chromosomeLen };
 
-	// Increase counter
-	crossCnt++;
+	// flattened stream is walked serially, one stream per generation
+	CounterRng rng{ streams(generations, 0, RngOp::MUTATION) };
+	this->mutCnt += mutation.apply(nBits, rng, [&](std::uint64_t pos) {
+		pop.population[pos / chromosomeLen].genotype.flip(pos % chromosomeLen);
+	});
+}
 
-	chromosome_t ch1{ parent1.genotype };
-	chromosome_t ch2{ parent2.genotype };
+template<std::size_t PopSize>
+SGA<PopSize>::Population::Population(std::size_t n) : 
+	population(n), decoded(n), evaluated(n), sumFitness(), avgFitness(), maxFitness(), minFitness(), rawMaxFitness() {
+}
 
-	// simple genotype crossing
-	std::swap_ranges(ch1.begin(), ch1.begin() + cp, ch2.begin());
-	
-	// create individuals based on their genotype
-	Individual child1{ ch1 };
-	Individual child2{ ch2 };
+template<std::size_t PopSize>
+SGA<PopSize>::Population::~Population() {}
 
-	// return crossed pair of children
-	return std::make_pair(child1, child2);
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::scaleLinear() {
+	FitnessSummary summary{ sumFitness, avgFitness, maxFitness, minFitness };
+	setStatistics(stats::scaleLinear(evaluated.data(), evaluated.data(), population.size(), summary));
 }
 
-void SGA::mutatePopulation(Population & pop) {
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::write(std::ostream & file) const {
+	const fitness_t stats[]{ sumFitness, avgFitness, maxFitness, minFitness };
+	file.write(reinterpret_cast<const char *>(stats), sizeof(stats));
 
-	for (Individual & ind : pop.population) {
-		for (allele_t & all : ind.genotype) {
-			if (this->mutFlip(gen)) {
-				all = !all;
-				this->mutCnt++;
-			}
-		}
+	for (const Individual & ind : population) {
+		file.write(reinterpret_cast<const char *>(&ind.fitness), sizeof(ind.fitness));
+		ind.genotype.write(file);
 	}
 }
 
-SGA::Population::Population() : 
-	population(), sumFitness(), avgFitness(), maxFitness(), minFitness() {
-}
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::decodeIndividuals(batch_fitness_t & fitFunc,
+	ThreadPool & pool, Schedule schedule, std::size_t grain) {
 
-SGA::Population::~Population() {}
+	pool.parallelFor(population.size(), schedule, grain, [&](std::size_t begin, std::size_t end, std::size_t) {
+		// evaluate in chunks of at most grain individuals
+		for (std::size_t chunk = begin; chunk < end; chunk += grain) {
+			std::size_t chunkEnd{ std::min(end, chunk + grain) };
 
-void SGA::Population::scaleLinear(){
-	fitness_t multiplier{ 2.0 };
-	fitness_t delta{ };
-	fitness_t a{ 1.0 };
-	fitness_t b{ 0.0 };
+			for (std::size_t i = chunk; i < chunkEnd; i++)
+				decoded[i] = population[i].decodeGenotype();
 
-	if (minFitness != maxFitness && multiplier != 1.0) {
-		if (minFitness > (multiplier * avgFitness - maxFitness) / (multiplier - 1.0)) {
-			delta = maxFitness - avgFitness;
-			a = (multiplier - 1.0) * avgFitness / delta;
-			b = avgFitness * (maxFitness - multiplier * avgFitness) / delta;
+			fitFunc(std::span<const fitness_t>(decoded.data() + chunk, chunkEnd - chunk),
+				std::span<fitness_t>(evaluated.data() + chunk, chunkEnd - chunk));
 		}
-		else {
-			delta = avgFitness - minFitness;
-			a = avgFitness / delta;
-			b = -minFitness * avgFitness / delta;
-		}
-	}
-
-	for (Individual & ind : population) {
-		ind.fitness = fabs(a * ind.fitness + b);
-	}
-}
-
-void SGA::Population::scaleNone(){
-
+	});
 }
 
-void SGA::Population::resetIDs() {
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::updateIndividuals() {
 	int IDcnt{ };
-	for (Individual & ind : this->population) {
+	for (std::size_t i = 0; i < population.size(); i++) {
+		Individual & ind{ population[i] };
+		ind.fitness = evaluated[i];
+		ind.expectedCopies = evaluated[i] / avgFitness;
 		ind.id = IDcnt++;
 	}
 }
 
-void SGA::Population::decodeIndividuals(std::function<fitness_t(fitness_t)>& fitFunc) {
-	for (Individual & ind : this->population) {
-		ind.decodeGenotype();
-		ind.fitness = fitFunc(ind.fitness);
-	}
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::calculateStatistics() {
+	setStatistics(stats::summarize(evaluated.data(), population.size()));
 }
 
-void SGA::Population::updateIndividuals() {
-	for (Individual & ind : this->population) {
-		ind.expectedCopies = ind.fitness / this->avgFitness;
-	}
+template<std::size_t PopSize>
+void SGA<PopSize>::Population::setStatistics(const FitnessSummary & summary) {
+	sumFitness = summary.sum;
+	avgFitness = summary.avg;
+	maxFitness = summary.max;
+	minFitness = summary.min;
 }
 
-void SGA::Population::calculateStatistics() {
-	sumFitness = avgFitness = 0;
-	maxFitness = std::numeric_limits<fitness_t>::min();
-	minFitness = std::numeric_limits<fitness_t>::max();
-
-	for (const Individual & ind : this->population) {
-		sumFitness += ind.fitness;
-		maxFitness = std::max(maxFitness, ind.fitness);
-		minFitness = std::min(minFitness, ind.fitness);
-	}
-
-	avgFitness = sumFitness / popSize;
-}
+template<std::size_t PopSize>
+SGA<PopSize>::Individual::Individual() { }
 
-SGA::Individual::Individual() { }
-
-SGA::Individual::Individual(chromosome_t chrom) : 
+template<std::size_t PopSize>
+SGA<PopSize>::Individual::Individual(chromosome_t chrom) : 
 	genotype(chrom), fitness( 0.0 ), expectedCopies(0), id(-1) {
 }
 
-SGA::Individual::~Individual() {}
-
-void SGA::Individual::decodeGenotype() {
-	fitness_t x{ };
+template<std::size_t PopSize>
+SGA<PopSize>::Individual::~Individual() {}
 
-	int bitCnt{ chromosomeLen - 1 };
-	for (allele_t & al : this->genotype) {
-		if (al) x += std::pow(2.0, bitCnt);
-		bitCnt--;
-	}
-
-	this->fitness = x;
+template<std::size_t PopSize>
+auto SGA<PopSize>::Individual::decodeGenotype() const -> fitness_t {
+	return genotype.decode();
 }
 
-
+template class SGA<SGAConfig::fastPopSize>;
+template class SGA<dynamicSize>;
@@ -7,28 +7,98 @@
 #include <functional>
 #include <numeric>
 #include <algorithm>
+#include <vector>
+#include "../common/PackedGenome.h"
+#include "../common/GeometricMutation.h"
+#include "../common/Selection.h"
+#include "../common/PopulationBuffer.h"
+#include "../common/GenerationHistory.h"
+#include "../common/ThreadPool.h"
+#include "../common/CounterRng.h"
+#include "../common/FitnessStats.h"
+#include "../common/Checkpoint.h"
+#include "../common/StopCriteria.h"
+#include "../common/RunTrace.h"
+#include <memory>
+#include <span>
+#include <type_traits>
 
 enum class ScalingType {
 	NONE, LINEAR,
 };
 
+// ROULETTE		- alias table, O(1) per draw
+// DETERMINISTIC	- sure copies, then largest fractions of expected copies
+// TRUNCATION		- remainder stochastic, fractions compete in one bounded pass
+// SUS				- stochastic universal sampling, one spin with popSize pointers
 enum class SelectMethod {
-	ROULETTE, DETERMINISTIC, TRUNCATION,
+	ROULETTE, DETERMINISTIC, TRUNCATION, SUS,
 };
 
+enum class CrossingType {
+	SINGLE_POINT, MULTI_POINT, UNIFORM,
+};
+
+struct SGAConfig {
+	// population size of compile-time fast path SGA<fastPopSize>
+	static constexpr std::size_t fastPopSize { 30 };
+
+	unsigned int seed			{ 0u };
+	int maxGenerations			{ 100 };
+	int popSize					{ static_cast<int>(fastPopSize) };
+	double mutProb				{ 0.03 };
+	double crossProb			{ 0.6 };
+	SelectMethod selectMethod	{ SelectMethod::ROULETTE };
+	ScalingType scalingType		{ ScalingType::NONE };
+	CrossingType crossingType	{ CrossingType::SINGLE_POINT };
+	int chromosomeLen			{ 10 };		// 2..1023 bits, decoded value must stay finite
+	int crossPoints				{ 2 };		// used only by MULTI_POINT
+	HistoryConfig history;
+	CheckpointConfig checkpoint;
+	StopConfig stop;			// early stop before maxGenerations
+	TraceConfig trace;			// per-generation stats (and genomes) in background
+
+	// fitness evaluation threads, fitness function has to be thread safe when > 1
+	std::size_t threads			{ 1 };
+	Schedule schedule			{ Schedule::STATIC };
+	std::size_t grain			{ 64 };		// individuals per scheduled chunk
+};
+
+struct SGAStats {
+	double sumFitness;
+	double avgFitness;
+	double maxFitness;
+	double minFitness;
+	int generations;
+	std::uint64_t mutations;
+	int crossings;
+	std::uint64_t evaluations;	// fitness function calls, initial population included
+	double rawMaxFitness;		// maxFitness before scaling
+};
+
+// PopSize = dynamicSize keeps population on heap, sized by SGAConfig::popSize
+// fixed PopSize keeps it in place, SGA<SGAConfig::fastPopSize> is the only instantiated one
+template<std::size_t PopSize = dynamicSize>
 class SGA {
+	static_assert(PopSize == dynamicSize || PopSize % 2 == 0, "fixed population size has to be even");
 
-	static constexpr int popSize		{ 30 };		// even number
-	static constexpr int chromosomeLen	{ 10 };
-	static constexpr double mutProb		{ 0.03 };
-	static constexpr double crossProb	{ 0.6 };
+	const int popSize					{ 30 };
+	const double mutProb				{ 0.03 };
+	const double crossProb				{ 0.6 };
 
-	const unsigned int inputSeed		{ 0u };
+	unsigned int inputSeed				{ 0u };
 	const int maxGenerations			{ 100 };
+	const int chromosomeLen				{ 10 };
+	const int crossPoints				{ 2 };
 	
-	using allele_t = bool;
 	using fitness_t = double;
-	using chromosome_t = std::array<allele_t, chromosomeLen>;
+	using chromosome_t = PackedGenome;
+
+public:
+	// fills fitness[i] for decoded genotype value x[i], spans are at most SGAConfig::grain long
+	using batch_fitness_t = std::function<void(std::span<const fitness_t> x, std::span<fitness_t> fitness)>;
+
+private:
 
 	struct Individual {
 		chromosome_t genotype;
@@ -36,7 +106,7 @@ class SGA {
 		fitness_t expectedCopies;    //  individual fitness / avg population fitness
 		int id;
 
-		void decodeGenotype();	// decodes genotype and updates fitness value
+		auto decodeGenotype() const -> fitness_t;	// decodes genotype as unsigned binary number
 		Individual();
 		Individual(chromosome_t chrom);
 		~Individual();
@@ -44,84 +114,189 @@ class SGA {
 
 		friend std::ostream & operator<<(std::ostream & stream, const SGA::Individual & ind) {
 			stream << "ID = " << std::setw(3) << ind.id;
-			stream << ", Genotype: ";
-			for (auto & al : ind.genotype)
-				stream << al;
+			stream << ", Genotype: " << ind.genotype;
 			stream << ", Fitness = " << ind.fitness;
 			return stream;
 		}
 	};
 
 	struct Population {
-		std::array<Individual, popSize> population;
+		PopulationBuffer<Individual, PopSize> population;
+
+		// decoded genotypes and their fitness, contiguous for batch kernels
+		PopulationBuffer<fitness_t, PopSize> decoded;
+		PopulationBuffer<fitness_t, PopSize> evaluated;
 
 		fitness_t sumFitness;
 		fitness_t avgFitness;
 		fitness_t maxFitness;
 		fitness_t minFitness;
+		fitness_t rawMaxFitness;	// max before scaling
 
-		Population();
+		Population(std::size_t n);
 		~Population();
 
-		void resetIDs();
+		// fitness of every individual is written to its own slot, so result
+		// does not depend on how the pool splits the population
+		void decodeIndividuals(batch_fitness_t & fitFunc,
+			ThreadPool & pool, Schedule schedule, std::size_t grain);
+
+		// stats (sum, avg, min, max) of evaluated fitness, one pass
 		void calculateStatistics();
-		void decodeIndividuals(std::function<fitness_t(fitness_t)>& fitFunc);
-		void updateIndividuals();
+		// scales evaluated fitness in place and updates stats, one pass
 		void scaleLinear();
-		void scaleNone();
+		// writes fitness, expected copies and ID back to individuals
+		void updateIndividuals();
+		void setStatistics(const FitnessSummary & summary);
+
+		// binary dump: stats, then (fitness, genotype words) of every individual
+		void write(std::ostream & file) const;
 	};
 
 	SelectMethod selectMethod;
 	ScalingType scalingType;
-	std::function<fitness_t(fitness_t)> fitnessFunction;
+	CrossingType crossingType;
+	batch_fitness_t fitnessFunction;
+
+	// buffers[lastIndex] holds last population, the other one is filled by next generation
+	std::vector<Population> buffers;
+	std::size_t lastIndex;
+	GenerationHistory<Population> history;
+
+	// Fitness evaluation
+	ThreadPool pool;
+	Schedule schedule;
+	std::size_t grain;
 
-	Population lastPop;
-	Population currPop;
+	auto lastPop() -> Population& { return buffers[lastIndex]; }
+	auto currPop() -> Population& { return buffers[lastIndex ^ 1]; }
 
 	// Counters
-	int mutCnt;
+	std::uint64_t mutCnt;
 	int crossCnt;
 	int generations;
 
-	// Random generators
-	std::random_device rd;
-	std::mt19937_64 gen;
-	std::uniform_real_distribution<fitness_t> fractionDis;
+	// Random generators, keyed by (seed, generation, individual, operator)
+	RngStreams streams;
 	std::uniform_int_distribution<int> crossPointDis;
-	std::bernoulli_distribution mutFlip;
+	std::vector<std::size_t> crossPointBuf;
+	GeometricMutation mutation;
 	std::bernoulli_distribution crossFlip;
 
+	// Selection buffers, reused between generations
+	AliasTable aliasTable;
+	std::vector<fitness_t> weightBuf;
+	std::vector<fitness_t> fractionBuf;
+	std::vector<std::size_t> orderBuf;
+	std::vector<std::size_t> selectedBuf;
+
+	CheckpointConfig checkpoint;
+	std::vector<char> checkpointBuf;
+	std::unique_ptr<CheckpointWriter> checkpointWriter;	// started by first checkpoint
+
+	StopCriteria stopping;
+	LocusCounter loci;
+
+	std::unique_ptr<TraceWriter> tracer;	// only when trace path is given
+
 	// Scaling functions, update Individuals "fitness" fields in pop
-	
-	inline auto getRandomFraction() -> fitness_t { return fractionDis(gen); }
 
 	auto scalePopulation(Population & pop) ->void;
-	auto selectPopulation(Population & last, Population & curr) -> void;
-	auto deterministicSelection(const Population & last, Population & curr) -> void;
-	auto rouletteSelection(const Population & last, Population & curr) -> void;
-	auto truncationSelection(const Population & last, Population & curr) -> void; 
-	auto crossPopulation(Population & curr) -> void;
+	// selection methods fill selectedBuf with indices of individuals in last population, nothing is copied
+	auto selectPopulation(const Population & last) -> void;
+	auto deterministicSelection(const Population & last) -> void;
+	auto rouletteSelection(const Population & last) -> void;
+	auto truncationSelection(const Population & last) -> void; 
+	auto universalSelection(const Population & last) -> void;
+	// writes children of selected parent pairs from last straight into curr, each genotype once
+	auto crossPopulation(const Population & last, Population & curr) -> void;
 	auto calculatePopulation(Population & pop) ->void;
-	auto simpleCrossing(const Individual & parent1, const Individual & parent2) -> std::pair<Individual, Individual>;
+	auto crossing(const Individual & parent1, const Individual & parent2,
+		Individual & child1, Individual & child2, CounterRng & rng) -> void;
 	auto mutatePopulation(Population & pop) -> void;
 	auto evolvePopulation(Population & last, Population & curr) ->void;
 	auto debug(std::ostream & file, Population & pop) -> void;
+	// fills last population with random genotypes of current seed and evaluates it
+	auto initPopulation() -> void;
+	// feeds unscaled stats of just evaluated population to stop criteria
+	auto shouldStop(const Population & pop) -> bool;
+	// appends unscaled stats (and genomes) of just evaluated population to trace
+	auto traceGeneration(const Population & pop) -> void;
+
+	// config values, or defaults when they would break crossing or allocation
+	static auto popSizeOf(const SGAConfig & config) -> int;
+	static auto chromosomeLenOf(const SGAConfig & config) -> int;
 
 public:
 	SGA(unsigned int seed = 0u, int maxGen = 100, SelectMethod selectM = SelectMethod::ROULETTE,
 		ScalingType scaleType = ScalingType::NONE,
-		std::function<fitness_t(fitness_t)> fitFunc = [&](fitness_t x) { return x; });
+		std::function<fitness_t(fitness_t)> fitFunc = [](fitness_t x) { return x; });
+	// Fitness interfaces, all of them end up as one batch call per chunk of population:
+	//	std::function	- one type erased call per individual, kept for compatibility
+	//	functor			- any fitness_t(fitness_t) callable, inlined into batch loop
+	//	batch			- user kernel over spans, e.g. hand vectorized with AVX2
+	SGA(const SGAConfig & config, std::function<fitness_t(fitness_t)> fitFunc);
+	SGA(const SGAConfig & config, batch_fitness_t batchFunc);
+
+	template<typename Fitness>
+	SGA(const SGAConfig & config, Fitness fitFunc) : SGA(config, toBatch(std::move(fitFunc))) {}
+
 	~SGA();
 
+	template<typename Fitness>
+	static auto toBatch(Fitness fitFunc) -> batch_fitness_t {
+		if constexpr (std::is_invocable_v<Fitness &, std::span<const fitness_t>, std::span<fitness_t>>) {
+			return batch_fitness_t{ std::move(fitFunc) };
+		}
+		else {
+			return [fitFunc](std::span<const fitness_t> x, std::span<fitness_t> fitness) {
+				for (std::size_t i = 0; i < x.size(); i++)
+					fitness[i] = fitFunc(x[i]);
+			};
+		}
+	}
+
 	void evolution() {
 		
 		std::cout << "Starting with seed: " << inputSeed << '\n';
 		std::cout << "MaxGenerations = " << maxGenerations << '\n';
-		debug(std::cout, lastPop);
+		debug(std::cout, lastPop());
+
+		run();
+		debug(std::cout, lastPop());
+		if (stopping.stopped())
+			std::cout << "Stopped at generation " << generations << ": " << toString(stopping.reason()) << '\n';
+	}
+
+	// evolves up to maxGenerations or stop criterion without any output (resumed run evolves only the rest)
+	void run() {
+		while (generations < maxGenerations && !stopping.stopped())
+			evolvePopulation(lastPop(), currPop());
+	}
+
+	// evolves given number of generations, never past maxGenerations or stop criterion
+	void step(int count = 1) {
+		for (int i = 0; i < count && generations < maxGenerations && !stopping.stopped(); i++)
+			evolvePopulation(lastPop(), currPop());
+	}
+
+	auto stopReason() const -> StopReason { return stopping.reason(); }
+
+	// starts again from generation 0 with new seed, population buffers are kept
+	void reseed(unsigned int seed);
+
+	// snapshot of last population, counters and seed, written in background to config path
+	void saveCheckpoint();
+	void saveCheckpoint(const std::string & path);
+
+	// restores state saved by saveCheckpoint, false (state untouched) when file is missing or does not match config
+	auto loadCheckpoint(const std::string & path) -> bool;
 
-		for(int i = 1; i <= maxGenerations; i++)
-			evolvePopulation(lastPop, currPop);
-		debug(std::cout, currPop);
+	auto stats() -> SGAStats {
+		const Population & pop{ lastPop() };
+		return SGAStats{ pop.sumFitness, pop.avgFitness, pop.maxFitness, pop.minFitness,
+			generations, mutCnt, crossCnt, static_cast<std::uint64_t>(popSize) * (generations + 1),
+			pop.rawMaxFitness };
 	}
 
 };
@@ -1,18 +1,100 @@
 ﻿// SimpleGeneticAlgorithm.cpp : This file contains the 'main' function. Program execution begins and ends there.
 
 #include "SGA.h"
+#include "../common/SeedSweep.h"
+#include <string>
 
+// evolves every seed of sweep with given config, one generation at a time to find best generation
+auto seedSweep(const SGAConfig & config, const SweepConfig & sweepConfig) -> void {
+	auto make = [&](std::size_t) { return std::make_unique<SGA<>>(config, [](double x) { return x * x; }); };
+	auto run = [&](SGA<> & sga, unsigned int seed) {
+		sga.reseed(seed);
+		SGAStats stats{ sga.stats() };
+		SweepRecord record{ seed, stats.rawMaxFitness };
+		while (stats.generations < config.maxGenerations && sga.stopReason() == StopReason::NONE) {
+			sga.step();
+			stats = sga.stats();
+			if (stats.rawMaxFitness > record.best) {
+				record.best = stats.rawMaxFitness;
+				record.bestGeneration = stats.generations;
+			}
+		}
+		record.generations = stats.generations;
+		record.evaluations = stats.evaluations;
+		return record;
+	};
+
+	std::vector<SweepRecord> records{ sweep::run(sweepConfig, make, run) };
+	if (!sweepConfig.output.empty()) sweep::write(sweepConfig.output, records);
+	sweep::printQuantiles(std::cout, records);
+}
+
+// config arguments following seed, argv[first] is popSize
+auto readConfig(int argc, char ** argv, int first, SGAConfig & config) -> void {
+	auto has = [&](int k) { return argc > first + k; };
+	auto arg = [&](int k) { return std::string(argv[first + k]); };
+
+	if (has(0)) config.popSize = std::stoi(arg(0));
+	if (has(1)) config.chromosomeLen = std::stoi(arg(1));
+	if (has(2)) config.mutProb = std::stod(arg(2));
+	if (has(3)) config.crossProb = std::stod(arg(3));
+	// run with checkpoint file continues from it when it exists
+	if (has(4)) config.checkpoint.path = arg(4);
+	if (has(5)) config.checkpoint.interval = std::stoi(arg(5));
+	// stops when best fitness did not improve for that many generations
+	if (has(6)) config.stop.stagnationWindow = std::stoi(arg(6));
+	// binary trace of every generation, read by trace_dump
+	if (has(7)) config.trace.path = arg(7);
+	if (has(8)) config.trace.genomes = std::stoi(arg(8)) != 0;
+}
+
+// usage: SimpleGeneticAlgorithm [seed] [popSize] [chromosomeLen] [mutProb] [crossProb] [checkpoint] [interval] [stagnation] [trace] [traceGenomes]
+//        SimpleGeneticAlgorithm sweep [firstSeed] [seeds] [output.csv|.bin] [threads] [popSize] ... [traceGenomes]
+//        (sweep takes the same arguments as single run after threads, seed excluded)
 int main(int argc, char ** argv) {
 	std::ios_base::sync_with_stdio(false);
 
-	unsigned seed = 5489u;
+	SGAConfig config;
+	config.seed = 5489u;
+	config.maxGenerations = 10000;
+	config.selectMethod = SelectMethod::ROULETTE;
+	config.scalingType = ScalingType::LINEAR;
 	
-	if(argc == 2) {
-		seed = std::stoi(argv[1]);	
+	if (argc > 1 && std::string(argv[1]) == "sweep") {
+		SweepConfig sweepConfig;
+		if (argc > 2) sweepConfig.firstSeed = std::stoi(argv[2]);
+		if (argc > 3) sweepConfig.seeds = std::stoul(argv[3]);
+		if (argc > 4) sweepConfig.output = argv[4];
+		if (argc > 5) sweepConfig.threads = std::stoul(argv[5]);
+		readConfig(argc, argv, 6, config);
+
+		// one file could not hold state of every seed
+		if (!config.checkpoint.path.empty()) {
+			std::cerr << "Config Error! checkpoints are not supported by sweep, " << config.checkpoint.path << " ignored\n";
+			config.checkpoint.path.clear();
+		}
+		if (!config.trace.path.empty()) {
+			std::cerr << "Config Error! traces are not supported by sweep, " << config.trace.path << " ignored\n";
+			config.trace.path.clear();
+		}
+		seedSweep(config, sweepConfig);
+		return 0;
+	}
+
+	if (argc > 1) config.seed = std::stoi(argv[1]);
+	readConfig(argc, argv, 2, config);
+
+	auto fitFunc = [](double x) { return x * x; };
+
+	// default population size runs on compile-time fast path
+	if (config.popSize == SGAConfig::fastPopSize) {
+		SGA<SGAConfig::fastPopSize> sga{ config, fitFunc };
+		sga.evolution();
+	}
+	else {
+		SGA<> sga{ config, fitFunc };
+		sga.evolution();
 	}
-	
-	SGA sga{ seed, 10000, SelectMethod::ROULETTE, ScalingType::LINEAR, [&](double x) { return x * x; } };
-	sga.evolution();
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+/* Trace Dump
+*
+* Reads run trace written by TraceConfig (common/RunTrace.h) straight from
+* memory-mapped file and prints generations as text. Only columns that are
+* printed or filtered on are touched, so scanning stats of a trace with
+* genomes does not read the genome columns at all.
+*
+* usage: trace_dump <trace> [options]
+*	--from N		first generation printed
+*	--to N			last generation printed
+*	--every N		every N-th generation only
+*	--above X		generations with max fitness >= X only
+*	--best			best genome of every printed generation
+*	--genomes		every genome of every printed generation
+*	--summary		header and generation count only
+*/
+
+#include "../common/RunTrace.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace {
+
+struct DumpOptions {
+	std::int32_t from{ std::numeric_limits<std::int32_t>::min() };
+	std::int32_t to{ std::numeric_limits<std::int32_t>::max() };
+	std::int32_t every{ 1 };
+	double above{ -std::numeric_limits<double>::infinity() };
+	bool best{ false };
+	bool genomes{ false };
+	bool summary{ false };
+};
+
+// read-only mapping of whole file, unmapped on destruction
+class MappedFile {
+	const char * bytes{ nullptr };
+	std::size_t length{ 0 };
+
+public:
+	explicit MappedFile(const std::string & path) {
+		int fd{ ::open(path.c_str(), O_RDONLY) };
+		if (fd < 0) return;
+		struct stat info {};
+		if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+			void * mapped{ ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0) };
+			if (mapped != MAP_FAILED) {
+				bytes = static_cast<const char *>(mapped);
+				length = static_cast<std::size_t>(info.st_size);
+			}
+		}
+		::close(fd);
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	~MappedFile() {
+		if (bytes) ::munmap(const_cast<char *>(bytes), length);
+	}
+
+	auto data() const -> const char * { return bytes; }
+	auto size() const -> std::size_t { return length; }
+};
+
+auto engineName(TraceEngine engine) -> const char * {
+	switch (engine) {
+	case TraceEngine::SGA: return "SGA";
+	case TraceEngine::GA: return "GeneticAlgorithm";
+	case TraceEngine::GAP: return "GAP";
+	}
+	return "unknown";
+}
+
+// genome as bit string, locus 0 first, as engines print it
+auto printGenome(std::ostream & stream, const TraceHeader & header, const std::uint64_t * words) -> void {
+	for (std::size_t locus = 0; locus < header.genomeBits; locus++)
+		stream << traceLocus(header, words, locus);
+}
+
+}
+
+int main(int argc, char ** argv) {
+	if (argc < 2) {
+		std::cerr << "usage: trace_dump <trace> [--from N] [--to N] [--every N] [--above X] [--best] [--genomes] [--summary]\n";
+		return 1;
+	}
+
+	DumpOptions options;
+	for (int i = 2; i < argc; i++) {
+		std::string arg{ argv[i] };
+		bool hasValue{ i + 1 < argc };
+		if (arg == "--from" && hasValue) options.from = std::stoi(argv[++i]);
+		else if (arg == "--to" && hasValue) options.to = std::stoi(argv[++i]);
+		else if (arg == "--every" && hasValue) options.every = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "--above" && hasValue) options.above = std::stod(argv[++i]);
+		else if (arg == "--best") options.best = true;
+		else if (arg == "--genomes") options.genomes = true;
+		else if (arg == "--summary") options.summary = true;
+		else {
+			std::cerr << "Trace Error! unknown option " << arg << '\n';
+			return 1;
+		}
+	}
+
+	MappedFile file{ argv[1] };
+	if (!file.data()) {
+		std::cerr << "Trace Error! cannot map " << argv[1] << '\n';
+		return 1;
+	}
+
+	TraceView trace{ file.data(), file.size() };
+	if (!trace.good()) {
+		std::cerr << "Trace Error! " << argv[1] << " is not a run trace\n";
+		return 1;
+	}
+
+	const TraceHeader & header{ trace.header() };
+	std::size_t popSize{ static_cast<std::size_t>(header.popSize) };
+	std::size_t genomeWords{ static_cast<std::size_t>(header.genomeWords) };
+	std::size_t genomeBits{ static_cast<std::size_t>(header.genomeBits) };
+
+	std::cout << "# engine: " << engineName(header.engine) << "  popSize: " << popSize
+		<< "  genome bits: " << genomeBits << "  genomes stored: " << (trace.hasGenomes() ? "yes" : "no")
+		<< "  generations: " << trace.rows() << '\n';
+	if (!trace.complete())
+		std::cerr << "Trace Error! " << argv[1] << " ends inside a block, later generations are lost\n";
+	if (options.summary) return 0;
+
+	if ((options.best || options.genomes) && !trace.hasGenomes()) {
+		std::cerr << "Trace Error! genomes were not traced, --best and --genomes ignored\n";
+		options.best = options.genomes = false;
+	}
+
+	std::cout << std::setprecision(8) << "# generation evaluations max avg min\n";
+	trace.forEachBlock([&](const auto & block) {
+		for (std::size_t r = 0; r < block.rows; r++) {
+			std::int32_t generation{ block.generation[r] };
+			if (generation < options.from || generation > options.to || generation % options.every != 0) continue;
+			if (block.max[r] < options.above) continue;
+
+			std::cout << generation << ' ' << block.evaluations[r] << ' '
+				<< block.max[r] << ' ' << block.avg[r] << ' ' << block.min[r] << '\n';
+
+			const double * fitness{ block.fitness + r * popSize };
+			const std::uint64_t * words{ block.words + r * popSize * genomeWords };
+			if (options.genomes) {
+				for (std::size_t i = 0; i < popSize; i++) {
+					std::cout << "  " << fitness[i] << ' ';
+					printGenome(std::cout, header, words + i * genomeWords);
+					std::cout << '\n';
+				}
+			}
+			else if (options.best) {
+				std::size_t best{ static_cast<std::size_t>(std::max_element(fitness, fitness + popSize) - fitness) };
+				std::cout << "  best " << fitness[best] << ' ';
+				printGenome(std::cout, header, words + best * genomeWords);
+				std::cout << '\n';
+			}
+		}
+	});
+}